@@ -0,0 +1,229 @@
+#include "SudokuDefinitions.h"
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// boardSize - int value holding the number of rows, columns, and digits in the board (9, 16, or 25)
+extern int boardSize;
+
+// CacheHeader - start of the cache file, checked by every process that maps it
+typedef struct {
+    uint64_t magic;                     // CACHE_MAGIC
+    uint32_t version;                   // CACHE_VERSION (the layout of the slots)
+    uint32_t size;                      // board size of the entries
+    uint64_t rules;                     // hash of the variant rules of the entries (0 = standard sudoku)
+    uint32_t numSlots;                  // number of slots after the header
+    uint32_t slotBytes;                 // bytes per slot
+    uint32_t clock;                     // bumped on every use of a slot (stamps the slots for eviction)
+    uint32_t padding[7];                // keeps the slots 64-byte aligned
+} CacheHeader;
+
+// CacheSlot - one board's count and solution (readers take no lock, they retry if the sequence changed while they copied)
+typedef struct {
+    uint32_t sequence;                  // odd while a writer is changing the slot
+    uint32_t stamp;                     // clock of the last use (the oldest slot of a bucket is evicted first)
+    uint64_t hash;                      // hash of the board (0 = empty slot)
+    int32_t count;                      // number of solutions (only a lower bound if CACHE_CAPPED is set)
+    uint32_t flags;                     // CACHE_CAPPED and CACHE_SOLVED
+    uint64_t words[];                   // packed board, then the packed solution (if CACHE_SOLVED is set)
+} CacheSlot;
+
+// Cache - this process's mapping of the cache file
+typedef struct {
+    int fd;                             // open cache file (flock'ed by writers)
+    CacheHeader *header;                // start of the mapping
+    int words;                          // words of a packed board
+    pthread_mutex_t lock;               // serializes this process's writers (the file lock only keeps other processes out)
+    long long hits;                     // lookups answered from the file
+    long long misses;                   // lookups that had to search
+} Cache;
+
+// cache - the solution cache opened with --cache (NULL = no cache)
+Cache *cache = NULL;
+
+// SudokuCache - contains the following functions to share solution counts between sessions and processes through a mapped file
+bool openCache(char *path, uint64_t rules);                                      // maps the cache file, laying it out if it is new (rules = hash of the variant rules, 0 = standard)
+int lookupCache(int (*grid)[MAX_SIZE], int max, int (*solution)[MAX_SIZE]);      // returns the count of the board (up to the max) and copies its solution if solution isn't NULL (-1 if not cached)
+void storeCache(int (*grid)[MAX_SIZE], int count, int max, int (*solution)[MAX_SIZE]); // saves the count of a search with this max and one solution (NULL = none found)
+CacheSlot *cacheSlot(int index);                                                 // returns a slot of the mapping
+
+// maps the cache file, laying it out if it is new (rules = hash of the variant rules, 0 = standard)
+bool openCache(char *path, uint64_t rules) {
+    int fd = open(path, O_RDWR | O_CREAT, 0644);
+    if (fd < 0) {
+        perror(path);
+        return false;
+    }
+
+    //boards packed like the rows of a snapshot, twice per slot for the board and its solution
+    int words = boardSize * packedRowWords();
+    uint32_t slotBytes = (sizeof(CacheSlot) + 2 * words * sizeof(uint64_t) + 63) / 64 * 64;
+    size_t length = sizeof(CacheHeader) + (size_t)CACHE_SLOTS * slotBytes;
+
+    //the first process to open the file lays it out, under the lock so two can't both do it
+    CacheHeader header = {0};
+    flock(fd, LOCK_EX);
+    struct stat info;
+    bool fresh = fstat(fd, &info) == 0 && info.st_size == 0;
+    if (fresh) {
+        header = (CacheHeader){CACHE_MAGIC, CACHE_VERSION, boardSize, rules, CACHE_SLOTS, slotBytes, 0, {0}};
+        if (ftruncate(fd, length) != 0 || pwrite(fd, &header, sizeof(header), 0) != sizeof(header)) {
+            perror(path);
+            close(fd);
+            return false;
+        }
+        info.st_size = length;
+    } else if (pread(fd, &header, sizeof(header), 0) != sizeof(header)) {
+        header.magic = 0;
+    }
+    flock(fd, LOCK_UN);
+
+    if (header.magic != CACHE_MAGIC || header.version != CACHE_VERSION) {
+        fprintf(stderr, "%s isn't a solution cache of this version of Sudoku Maker.\n", path);
+    } else if (header.size != (uint32_t)boardSize) {
+        fprintf(stderr, "%s is a solution cache of %dx%d boards.\n", path, header.size, header.size);
+    } else if (header.rules != rules) {
+        fprintf(stderr, "%s is a solution cache of boards with other variant rules.\n", path);
+    } else if (header.numSlots != CACHE_SLOTS || header.slotBytes != slotBytes || (size_t)info.st_size != length) {
+        fprintf(stderr, "%s is a solution cache with a different layout.\n", path);
+    } else {
+        void *mapping = mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (mapping == MAP_FAILED) {
+            perror(path);
+            close(fd);
+            return false;
+        }
+        cache = calloc(1, sizeof(Cache));
+        cache->fd = fd;
+        cache->header = mapping;
+        cache->words = words;
+        pthread_mutex_init(&cache->lock, NULL);
+        return true;
+    }
+    close(fd);
+    return false;
+}
+
+// returns the count of the board (up to the max) and copies its solution if solution isn't NULL (-1 if not cached)
+int lookupCache(int (*grid)[MAX_SIZE], int max, int (*solution)[MAX_SIZE]) {
+    if (cache == NULL) {
+        return -1;
+    }
+    uint64_t key[SNAPSHOT_BOARD_WORDS];
+    packBoard(grid, key);
+    uint64_t hash = hashPacked(key, cache->words);
+    int bucket = (hash >> 32) & (CACHE_SLOTS - CACHE_WAYS);
+
+    for (int way = 0; way < CACHE_WAYS; way++) {
+        CacheSlot *slot = cacheSlot(bucket + way);
+        if (__atomic_load_n(&slot->hash, __ATOMIC_RELAXED) != hash) {
+            continue;
+        }
+
+        //copy the slot, and copy it again if a writer (in any process) changed it meanwhile
+        uint64_t words[2 * SNAPSHOT_BOARD_WORDS];
+        int count = 0;
+        uint32_t flags = 0;
+        bool consistent = false;
+        for (int attempt = 0; attempt < CACHE_RETRIES && !consistent; attempt++) {
+            uint32_t sequence = __atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE);
+            if (sequence & 1) {
+                continue;
+            }
+            count = slot->count;
+            flags = slot->flags;
+            memcpy(words, slot->words, 2 * cache->words * sizeof(uint64_t));
+            __atomic_thread_fence(__ATOMIC_ACQUIRE);
+            consistent = slot->hash == hash && __atomic_load_n(&slot->sequence, __ATOMIC_RELAXED) == sequence;
+        }
+        if (!consistent || memcmp(words, key, cache->words * sizeof(uint64_t)) != 0) {
+            continue;
+        }
+
+        //a capped count only answers searches that stop at or below it, and a solution has to be stored if one is asked for
+        if (((flags & CACHE_CAPPED) && count < max) || (solution != NULL && count > 0 && !(flags & CACHE_SOLVED))) {
+            break;
+        }
+        if (solution != NULL && count > 0) {
+            unpackBoard(words + cache->words, solution);
+        }
+        __atomic_store_n(&slot->stamp, __atomic_fetch_add(&cache->header->clock, 1, __ATOMIC_RELAXED), __ATOMIC_RELAXED);
+        __atomic_fetch_add(&cache->hits, 1, __ATOMIC_RELAXED);
+        return count < max ? count : max;
+    }
+
+    __atomic_fetch_add(&cache->misses, 1, __ATOMIC_RELAXED);
+    return -1;
+}
+
+// saves the count of a search with this max and one solution (NULL = none found)
+void storeCache(int (*grid)[MAX_SIZE], int count, int max, int (*solution)[MAX_SIZE]) {
+    if (cache == NULL) {
+        return;
+    }
+    uint64_t key[SNAPSHOT_BOARD_WORDS];
+    packBoard(grid, key);
+    uint64_t hash = hashPacked(key, cache->words);
+    int bucket = (hash >> 32) & (CACHE_SLOTS - CACHE_WAYS);
+    bool capped = count >= max;
+
+    pthread_mutex_lock(&cache->lock);
+    flock(cache->fd, LOCK_EX);
+
+    //the board's own slot, else an empty one, else the least recently used of its bucket
+    CacheSlot *target = NULL;
+    bool found = false;
+    for (int way = 0; way < CACHE_WAYS && !found; way++) {
+        CacheSlot *slot = cacheSlot(bucket + way);
+        found = slot->hash == hash && memcmp(slot->words, key, cache->words * sizeof(uint64_t)) == 0;
+        if (found || target == NULL || (target->hash != 0 && (slot->hash == 0 || (int32_t)(slot->stamp - target->stamp) < 0))) {
+            target = slot;
+        }
+    }
+
+    //keep whichever count says more (an exact count beats a lower bound, and a higher lower bound beats a lower one)
+    bool changed = !found || (solution != NULL && !(target->flags & CACHE_SOLVED));
+    if (found && ((target->flags & CACHE_CAPPED) == 0 || (capped && target->count >= count))) {
+        count = target->count;
+        capped = target->flags & CACHE_CAPPED;
+    } else {
+        changed = true;
+    }
+
+    if (changed) {
+        uint32_t sequence = target->sequence;
+        __atomic_store_n(&target->sequence, sequence + 1, __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_RELEASE);
+
+        uint32_t flags = capped ? CACHE_CAPPED : 0;
+        if (solution != NULL) {
+            packBoard(solution, target->words + cache->words);
+            flags |= CACHE_SOLVED;
+        } else if (found) {
+            flags |= target->flags & CACHE_SOLVED;
+        }
+        target->hash = hash;
+        target->count = count;
+        target->flags = flags;
+        memcpy(target->words, key, cache->words * sizeof(uint64_t));
+
+        __atomic_store_n(&target->sequence, sequence + 2, __ATOMIC_RELEASE);
+    }
+    __atomic_store_n(&target->stamp, __atomic_fetch_add(&cache->header->clock, 1, __ATOMIC_RELAXED), __ATOMIC_RELAXED);
+
+    flock(cache->fd, LOCK_UN);
+    pthread_mutex_unlock(&cache->lock);
+}
+
+// returns a slot of the mapping
+CacheSlot *cacheSlot(int index) {
+    return (CacheSlot *)((char *)(cache->header + 1) + (size_t)index * cache->header->slotBytes);
+}
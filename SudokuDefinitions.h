@@ -4,4 +4,48 @@
 #define UNDO_SIZE 40
 #define NOT_CHECKED 0
 #define WRONG -1
-#define CORRECT 1
\ No newline at end of file
+#define CORRECT 1
+#define MAX_SIZE 25
+#define NUM_SUGGESTIONS 3
+#define SUGGEST_SECONDS 2
+#define REDUCE_SECONDS 10
+#define SERVER_NODE_LIMIT 100000000
+#define ENUM_SUBTREES 256
+#define ENUM_BLOCK_SIZE 65536
+#define ENUM_QUOTA 1024
+#define ENUM_VERSION 1
+#define PROFILE_COUNTERS 4
+#define PROFILE_DEPTH 32
+#define FUZZ_OPS 7
+#define FUZZ_KINDS 5
+#define FUZZ_NODE_BUDGET 2000000
+#define FUZZ_REPORTS 10
+#define FUZZ_NODE_SLACK 5
+#define FUZZ_TIME_RUNS 5
+#define FUZZ_TIME_SLACK 50
+#define VARIANT_CAGE_SIZE 16
+#define VARIANT_MAX_SUM 136
+#define VARIANT_MAX_CAGES 256
+#define VARIANT_MAX_UNITS 333
+#define VARIANT_CELL_UNITS 6
+#define VARIANT_MAX_PEERS 144
+#define INCREMENTAL_NOGOODS 64
+#define PATTERN_TABLE_SIZE 4194304
+#define PATTERN_PROBES 16
+#define PATTERN_RESTART 64
+#define PATTERN_SECONDS 60
+#define SNAPSHOT_ROW_WORDS 3
+#define SNAPSHOT_BOARD_WORDS (MAX_SIZE * SNAPSHOT_ROW_WORDS)
+#define CACHE_SLOTS 65536
+#define CACHE_WAYS 4
+#define CACHE_RETRIES 64
+#define CACHE_MAGIC 0x31454843414353ULL
+#define CACHE_VERSION 2
+#define CACHE_CAPPED 1
+#define CACHE_SOLVED 2
+#define GRADE_CHUNK 4096
+#define GRADE_MAX_PEERS 64
+#define GRADE_CELL_WORDS 10
+#define GRADE_INVALID -1
+#define GRADE_NO_SOLUTION -2
+#define GRADE_NOT_UNIQUE -3
\ No newline at end of file
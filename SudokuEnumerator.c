@@ -0,0 +1,578 @@
+#include "SudokuDefinitions.h"
+#include <limits.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+// boardSize - int value holding the number of rows, columns, and digits in the board (9, 16, or 25)
+extern int boardSize;
+
+// SudokuEnumerator - writes every solution of a board to a file and reads them back
+// the file starts with a header:
+//   "SDKE", version (1 byte), board size (1 byte), number of subtrees (4 bytes), the board (boardSize * boardSize characters)
+// followed by blocks of solutions, each written by one thread for one subtree:
+//   subtree (4 bytes), generation (4 bytes), solutions (4 bytes), payload length (4 bytes), flags (1 byte), payload
+// the payload stores each solution as the cells (from the board's empty cells, in order) that changed since the previous
+// solution of the block: the number of changes (varint), then for each change one byte holding the gap since the last changed cell
+// (top 3 bits) and the number (low 5 bits), where a gap of 7 or more is stored as 7 followed by the rest of the gap (varint)
+// a resumed run writes with a higher generation and only the blocks of each subtree's latest generation count
+// numbers are little endian, varints store 7 bits per byte (lowest first, high bit set if more follow)
+
+// Enumeration - state shared by the threads enumerating a board
+typedef struct {
+    int board[MAX_SIZE][MAX_SIZE];       // board being enumerated
+    int cells[MAX_SIZE * MAX_SIZE];      // the board's empty cells (the ones each solution stores)
+    int numCells;                        // number of entries in cells
+    int (*subtrees)[MAX_SIZE][MAX_SIZE]; // board with the first few empty cells filled in, one per subtree
+    int numSubtrees;                     // number of entries in subtrees
+    bool *done;                          // subtrees whose every solution is in the file
+    int next;                            // index of the next subtree to enumerate
+    uint32_t generation;                 // generation written by this run
+    long long limit;                     // maximum number of solutions in the file (0 = no limit)
+    long long total;                     // solutions in the file plus the ones threads have claimed
+    long long outstanding;               // solutions claimed by threads that may still be given back
+    bool stopped;                        // true once the limit is reached
+    FILE *file;                          // output file
+    pthread_mutex_t lock;                // guards next, total, outstanding, stopped, and writes to file
+    pthread_cond_t returned;             // signaled when a thread gives back what it claimed
+} Enumeration;
+
+// EnumWorker - one thread's block being filled
+typedef struct {
+    Enumeration *e;
+    pthread_t thread;
+    int subtree;                       // subtree being enumerated
+    uint8_t *buffer;                   // payload of the block
+    int length;                        // bytes used in buffer
+    uint32_t count;                    // solutions in buffer
+    uint8_t prev[MAX_SIZE * MAX_SIZE]; // previous solution of the block (0 = none yet)
+    long long quota;                   // solutions claimed from the limit but not written yet
+    long long claimed;                 // size of the latest claim
+    bool cut;                          // true if the limit cut the subtree short
+} EnumWorker;
+
+// EnumScan - what an existing file holds
+typedef struct {
+    int size;                            // board size
+    int numSubtrees;                     // number of subtrees the board was split into
+    char board[MAX_SIZE * MAX_SIZE + 1]; // board as a string
+    long start;                          // offset of the first block
+    long end;                            // offset after the last complete block
+    uint32_t *latest;                    // latest generation of each subtree
+    bool *done;                          // subtrees finished in their latest generation
+    long long *counts;                   // solutions of each subtree in its latest generation
+    uint32_t generation;                 // highest generation in the file
+} EnumScan;
+
+// SudokuEnumerator - contains the following functions to write every solution of a board to a file and read them back
+int runEnumeration(char *boardStr, char *path, long long limit, bool resume, int numThreads); // writes the solutions of a board to a file (resuming a previous run if asked)
+int runDecode(char *path);                                                                   // prints every solution in a file as a board string
+int splitSubtrees(Enumeration *e);                                                           // splits the search into subtrees by filling in the most constrained cells
+void *enumerateSubtrees(void *arg);                                                          // thread loop that enumerates subtrees until none are left
+void encodeSolution(int (*solution)[MAX_SIZE], void *data);                                  // visitor that appends a solution to the thread's block
+bool claimSolution(EnumWorker *w);                                                           // takes a solution from the limit (false if reached)
+void flushBlock(EnumWorker *w, bool done);                                                   // writes the thread's block to the file and starts a new one
+bool scanEnumFile(FILE *file, EnumScan *scan);                                               // reads the header and block headers of a file
+void freeEnumScan(EnumScan *scan);                                                           // frees the arrays of a scan
+int putVarint(uint8_t *buf, uint32_t value);                                                 // writes a varint (returns its length)
+uint32_t getVarint(uint8_t **buf);                                                           // reads a varint and moves past it
+void putU32(uint8_t *buf, uint32_t value);                                                   // writes a little endian 4 byte number
+uint32_t getU32(const uint8_t *buf);                                                         // reads a little endian 4 byte number
+
+// writes the solutions of a board to a file (resuming a previous run if asked)
+int runEnumeration(char *boardStr, char *path, long long limit, bool resume, int numThreads) {
+    Enumeration *e = calloc(1, sizeof(Enumeration));
+    if (!parseBoard(boardStr, e->board, NULL)) {
+        fprintf(stderr, "error invalid board\n");
+        free(e);
+        return 1;
+    }
+    for (int row = 0; row < boardSize; row++) {
+        for (int col = 0; col < boardSize; col++) {
+            if (e->board[row][col] == EMPTY) {
+                e->cells[e->numCells++] = row * boardSize + col;
+            } else if (!kernel->isValidShallow(row, col, e->board[row][col], e->board)) {
+                fprintf(stderr, "error invalid board\n");
+                free(e);
+                return 1;
+            }
+        }
+    }
+    char text[MAX_SIZE * MAX_SIZE + 1];
+    formatBoard(e->board, text);
+    splitSubtrees(e);
+    e->done = calloc(e->numSubtrees, sizeof(bool));
+    e->limit = limit;
+    pthread_mutex_init(&e->lock, NULL);
+    pthread_cond_init(&e->returned, NULL);
+
+    //pick up where a previous run left off, or start a new file
+    FILE *file = resume ? fopen(path, "r+b") : NULL;
+    if (file != NULL) {
+        EnumScan scan;
+        if (!scanEnumFile(file, &scan) || scan.size != boardSize || scan.numSubtrees != e->numSubtrees || strcmp(scan.board, text) != 0) {
+            fprintf(stderr, "error %s was written for another board\n", path);
+            freeEnumScan(&scan);
+            fclose(file);
+            free(e->subtrees);
+            free(e->done);
+            free(e);
+            return 1;
+        }
+
+        //drop a block cut off by a crash, and keep the subtrees that were finished
+        if (ftruncate(fileno(file), scan.end) != 0) {
+            perror(path);
+            freeEnumScan(&scan);
+            fclose(file);
+            free(e->subtrees);
+            free(e->done);
+            free(e);
+            return 1;
+        }
+        fseek(file, scan.end, SEEK_SET);
+        e->generation = scan.generation + 1;
+        for (int i = 0; i < e->numSubtrees; i++) {
+            e->done[i] = scan.done[i];
+            if (scan.done[i]) {
+                e->total += scan.counts[i];
+            }
+        }
+        freeEnumScan(&scan);
+    } else {
+        file = fopen(path, "w+b");
+        if (file == NULL) {
+            perror(path);
+            free(e->subtrees);
+            free(e->done);
+            free(e);
+            return 1;
+        }
+        uint8_t header[10] = {'S', 'D', 'K', 'E', ENUM_VERSION, boardSize};
+        putU32(header + 6, e->numSubtrees);
+        fwrite(header, 1, sizeof(header), file);
+        fwrite(text, 1, boardSize * boardSize, file);
+    }
+    e->file = file;
+    e->stopped = limit > 0 && e->total >= limit;
+
+    //a large buffer keeps the threads from waiting on small writes
+    setvbuf(file, NULL, _IOFBF, ENUM_BLOCK_SIZE * 16);
+
+    //empty blocks of the new generation retire what earlier runs wrote for unfinished subtrees
+    int numDone = 0;
+    for (int i = 0; i < e->numSubtrees; i++) {
+        if (e->done[i]) {
+            numDone++;
+        } else if (e->generation > 0) {
+            uint8_t header[17] = {0};
+            putU32(header, i);
+            putU32(header + 4, e->generation);
+            fwrite(header, 1, sizeof(header), file);
+        }
+    }
+    long long before = e->total;
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    EnumWorker *workers = calloc(numThreads, sizeof(EnumWorker));
+    for (int i = 0; i < numThreads; i++) {
+        workers[i].e = e;
+        workers[i].buffer = malloc(ENUM_BLOCK_SIZE);
+        pthread_create(&workers[i].thread, NULL, enumerateSubtrees, &workers[i]);
+    }
+    for (int i = 0; i < numThreads; i++) {
+        pthread_join(workers[i].thread, NULL);
+        free(workers[i].buffer);
+    }
+    free(workers);
+
+    fflush(file);
+    long size = ftell(file);
+    fclose(file);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double seconds = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+
+    int finished = 0;
+    for (int i = 0; i < e->numSubtrees; i++) {
+        finished += e->done[i];
+    }
+    fprintf(stderr, "Wrote %lld solutions in %.3f seconds (%.0f per second), %s now holds %lld solutions in %ld bytes (%.2f bytes each).\n",
+            e->total - before, seconds, seconds > 0 ? (e->total - before) / seconds : 0.0, path, e->total, size, e->total > 0 ? (double)size / e->total : 0.0);
+    fprintf(stderr, "%d of %d subtrees finished (%d before this run)%s\n", finished, e->numSubtrees, numDone,
+            finished < e->numSubtrees ? ", rerun with --resume to continue." : ".");
+
+    pthread_mutex_destroy(&e->lock);
+    pthread_cond_destroy(&e->returned);
+    free(e->subtrees);
+    free(e->done);
+    free(e);
+    return 0;
+}
+
+// prints every solution in a file as a board string
+int runDecode(char *path) {
+    FILE *file = fopen(path, "rb");
+    if (file == NULL) {
+        perror(path);
+        return 1;
+    }
+    EnumScan scan;
+    if (!scanEnumFile(file, &scan) || !selectKernel(scan.size)) {
+        fprintf(stderr, "error %s is not a solution file\n", path);
+        freeEnumScan(&scan);
+        fclose(file);
+        return 1;
+    }
+
+    int board[MAX_SIZE][MAX_SIZE];
+    parseBoard(scan.board, board, NULL);
+    int cells[MAX_SIZE * MAX_SIZE];
+    int numCells = 0;
+    for (int cell = 0; cell < boardSize * boardSize; cell++) {
+        if (board[cell / boardSize][cell % boardSize] == EMPTY) {
+            cells[numCells++] = cell;
+        }
+    }
+
+    //only the latest generation of each subtree counts
+    uint8_t *payload = malloc(ENUM_BLOCK_SIZE);
+    char *out = malloc(MAX_SIZE * MAX_SIZE + 1);
+    fseek(file, scan.start, SEEK_SET);
+    while (ftell(file) < scan.end) {
+        uint8_t header[17];
+        fread(header, 1, sizeof(header), file);
+        uint32_t subtree = getU32(header);
+        uint32_t count = getU32(header + 8);
+        uint32_t length = getU32(header + 12);
+        fread(payload, 1, length, file);
+        if (getU32(header + 4) != scan.latest[subtree]) {
+            continue;
+        }
+
+        //every block starts over from the board
+        int solution[MAX_SIZE][MAX_SIZE];
+        memcpy(solution, board, sizeof(solution));
+        uint8_t *p = payload;
+        for (uint32_t i = 0; i < count; i++) {
+            uint32_t changes = getVarint(&p);
+            int index = -1;
+            for (uint32_t j = 0; j < changes; j++) {
+                int gap = *p >> 5;
+                int num = *p++ & 0x1F;
+                if (gap == 7) {
+                    gap += getVarint(&p);
+                }
+                index += gap + 1;
+                solution[cells[index] / boardSize][cells[index] % boardSize] = num;
+            }
+            formatBoard(solution, out);
+            puts(out);
+        }
+    }
+
+    free(payload);
+    free(out);
+    freeEnumScan(&scan);
+    fclose(file);
+    return 0;
+}
+
+// splits the search into subtrees by filling in the most constrained cells
+int splitSubtrees(Enumeration *e) {
+    //the split only depends on the board, so a resumed run gets the same subtrees
+    int capacity = ENUM_SUBTREES * MAX_SIZE;
+    int (*level)[MAX_SIZE][MAX_SIZE] = malloc(sizeof(int[MAX_SIZE][MAX_SIZE]) * capacity);
+    int (*nextLevel)[MAX_SIZE][MAX_SIZE] = malloc(sizeof(int[MAX_SIZE][MAX_SIZE]) * capacity);
+    memcpy(level[0], e->board, sizeof(e->board));
+    int num = 1;
+
+    while (num < ENUM_SUBTREES) {
+        int numNext = 0;
+        bool split = false;
+        for (int i = 0; i < num; i++) {
+            //find the empty cell with the fewest numbers left
+            int bestCell = -1, bestCount = MAX_SIZE + 1;
+            for (int cell = 0; cell < boardSize * boardSize && bestCount > 0; cell++) {
+                int row = cell / boardSize, col = cell % boardSize;
+                if (level[i][row][col] != EMPTY) {
+                    continue;
+                }
+                int count = 0;
+                for (int n = 1; n <= boardSize; n++) {
+                    count += kernel->isValidShallow(row, col, n, level[i]);
+                }
+                if (count < bestCount) {
+                    bestCell = cell;
+                    bestCount = count;
+                }
+            }
+
+            if (bestCell < 0) {
+                //already solved, stays a subtree of its own
+                memcpy(nextLevel[numNext++], level[i], sizeof(level[i]));
+                continue;
+            }
+
+            //one subtree per number the cell can take (none if it can't take any)
+            int row = bestCell / boardSize, col = bestCell % boardSize;
+            for (int n = 1; n <= boardSize; n++) {
+                if (kernel->isValidShallow(row, col, n, level[i])) {
+                    memcpy(nextLevel[numNext], level[i], sizeof(level[i]));
+                    nextLevel[numNext++][row][col] = n;
+                }
+            }
+            split = true;
+        }
+
+        int (*swap)[MAX_SIZE][MAX_SIZE] = level;
+        level = nextLevel;
+        nextLevel = swap;
+        num = numNext;
+        if (!split || num == 0) {
+            break;
+        }
+    }
+
+    free(nextLevel);
+    e->subtrees = level;
+    e->numSubtrees = num;
+    return num;
+}
+
+// thread loop that enumerates subtrees until none are left
+void *enumerateSubtrees(void *arg) {
+    EnumWorker *w = arg;
+    Enumeration *e = w->e;
+    int work[MAX_SIZE][MAX_SIZE];
+
+    while (true) {
+        pthread_mutex_lock(&e->lock);
+        while (e->next < e->numSubtrees && e->done[e->next]) {
+            e->next++;
+        }
+        if (e->stopped || e->next == e->numSubtrees) {
+            pthread_mutex_unlock(&e->lock);
+            break;
+        }
+        w->subtree = e->next++;
+        pthread_mutex_unlock(&e->lock);
+
+        //with a limit the search stops one solution past it, which can never be claimed and so cuts a subtree with more solutions than it keeps
+        int max = e->limit > 0 && e->limit < INT_MAX ? (int)e->limit + 1 : INT_MAX;
+        int count = 0;
+        w->cut = false;
+        memcpy(work, e->subtrees[w->subtree], sizeof(work));
+        kernel->forEachSolution(0, 0, work, &count, max, encodeSolution, w);
+
+        //a subtree is finished once every solution the search found was kept
+        bool done = !w->cut;
+        flushBlock(w, done);
+
+        //give back what the limit let this thread write but it didn't need
+        pthread_mutex_lock(&e->lock);
+        e->total -= w->quota;
+        e->outstanding -= w->claimed;
+        w->quota = 0;
+        w->claimed = 0;
+        pthread_cond_broadcast(&e->returned);
+        e->done[w->subtree] = done;
+        pthread_mutex_unlock(&e->lock);
+    }
+    return NULL;
+}
+
+// visitor that appends a solution to the thread's block
+void encodeSolution(int (*solution)[MAX_SIZE], void *data) {
+    EnumWorker *w = data;
+    Enumeration *e = w->e;
+    if (w->cut || !claimSolution(w)) {
+        w->cut = true;
+        return;
+    }
+
+    //start a new block if the worst case doesn't fit
+    if (w->length + 5 + e->numCells * 6 > ENUM_BLOCK_SIZE) {
+        flushBlock(w, false);
+    }
+
+    int changes = 0;
+    for (int i = 0; i < e->numCells; i++) {
+        changes += solution[e->cells[i] / boardSize][e->cells[i] % boardSize] != w->prev[i];
+    }
+    w->length += putVarint(w->buffer + w->length, changes);
+
+    int last = -1;
+    for (int i = 0; i < e->numCells; i++) {
+        int num = solution[e->cells[i] / boardSize][e->cells[i] % boardSize];
+        if (num != w->prev[i]) {
+            int gap = i - last - 1;
+            w->buffer[w->length++] = (gap < 7 ? gap : 7) << 5 | num;
+            if (gap >= 7) {
+                w->length += putVarint(w->buffer + w->length, gap - 7);
+            }
+            w->prev[i] = num;
+            last = i;
+        }
+    }
+    w->count++;
+}
+
+// takes a solution from the limit (false if reached)
+bool claimSolution(EnumWorker *w) {
+    Enumeration *e = w->e;
+    if (e->limit == 0) {
+        return true;
+    }
+
+    //claim in batches so threads rarely wait on the lock
+    if (w->quota == 0) {
+        pthread_mutex_lock(&e->lock);
+        e->outstanding -= w->claimed;
+        w->claimed = 0;
+
+        //once the limit is used up, wait for other threads to give back what they didn't need
+        while (!e->stopped && e->total >= e->limit && e->outstanding > 0) {
+            pthread_cond_wait(&e->returned, &e->lock);
+        }
+        if (e->total < e->limit) {
+            w->claimed = e->limit - e->total < ENUM_QUOTA ? e->limit - e->total : ENUM_QUOTA;
+            w->quota = w->claimed;
+            e->total += w->claimed;
+            e->outstanding += w->claimed;
+        } else {
+            e->stopped = true;
+        }
+        pthread_cond_broadcast(&e->returned);
+        pthread_mutex_unlock(&e->lock);
+    }
+    if (w->quota == 0) {
+        return false;
+    }
+    w->quota--;
+    return true;
+}
+
+// writes the thread's block to the file and starts a new one
+void flushBlock(EnumWorker *w, bool done) {
+    Enumeration *e = w->e;
+    if (w->count > 0 || done) {
+        uint8_t header[17];
+        putU32(header, w->subtree);
+        putU32(header + 4, e->generation);
+        putU32(header + 8, w->count);
+        putU32(header + 12, w->length);
+        header[16] = done;
+
+        pthread_mutex_lock(&e->lock);
+        fwrite(header, 1, sizeof(header), e->file);
+        fwrite(w->buffer, 1, w->length, e->file);
+        if (e->limit == 0) {
+            e->total += w->count;
+        }
+        pthread_mutex_unlock(&e->lock);
+    }
+
+    w->length = 0;
+    w->count = 0;
+    memset(w->prev, 0, sizeof(w->prev));
+}
+
+// reads the header and block headers of a file
+bool scanEnumFile(FILE *file, EnumScan *scan) {
+    memset(scan, 0, sizeof(EnumScan));
+    uint8_t header[17];
+    if (fread(header, 1, 10, file) != 10 || memcmp(header, "SDKE", 4) != 0 || header[4] != ENUM_VERSION) {
+        return false;
+    }
+    scan->size = header[5];
+    scan->numSubtrees = getU32(header + 6);
+    if (scan->size < 1 || scan->size > MAX_SIZE || scan->numSubtrees < 0 || scan->numSubtrees > ENUM_SUBTREES * MAX_SIZE) {
+        return false;
+    }
+    if (fread(scan->board, 1, scan->size * scan->size, file) != (size_t)(scan->size * scan->size)) {
+        return false;
+    }
+    scan->board[scan->size * scan->size] = '\0';
+    scan->start = ftell(file);
+    scan->end = scan->start;
+
+    scan->latest = calloc(scan->numSubtrees, sizeof(uint32_t));
+    scan->done = calloc(scan->numSubtrees, sizeof(bool));
+    scan->counts = calloc(scan->numSubtrees, sizeof(long long));
+
+    //stop at the first block that was cut off
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, scan->start, SEEK_SET);
+    while (fread(header, 1, sizeof(header), file) == sizeof(header)) {
+        uint32_t subtree = getU32(header);
+        uint32_t generation = getU32(header + 4);
+        uint32_t length = getU32(header + 12);
+        if (subtree >= (uint32_t)scan->numSubtrees || length > ENUM_BLOCK_SIZE || scan->end + (long)sizeof(header) + length > size) {
+            break;
+        }
+        fseek(file, length, SEEK_CUR);
+        scan->end += sizeof(header) + length;
+
+        if (generation > scan->latest[subtree]) {
+            scan->latest[subtree] = generation;
+            scan->done[subtree] = false;
+            scan->counts[subtree] = 0;
+        }
+        if (generation == scan->latest[subtree]) {
+            scan->counts[subtree] += getU32(header + 8);
+            scan->done[subtree] |= header[16] & 1;
+        }
+        scan->generation = generation > scan->generation ? generation : scan->generation;
+    }
+    return true;
+}
+
+// frees the arrays of a scan
+void freeEnumScan(EnumScan *scan) {
+    free(scan->latest);
+    free(scan->done);
+    free(scan->counts);
+}
+
+// writes a varint (returns its length)
+int putVarint(uint8_t *buf, uint32_t value) {
+    int len = 0;
+    while (value >= 0x80) {
+        buf[len++] = (value & 0x7F) | 0x80;
+        value >>= 7;
+    }
+    buf[len++] = value;
+    return len;
+}
+
+// reads a varint and moves past it
+uint32_t getVarint(uint8_t **buf) {
+    uint32_t value = 0;
+    int shift = 0;
+    while (**buf & 0x80) {
+        value |= (uint32_t)(*(*buf)++ & 0x7F) << shift;
+        shift += 7;
+    }
+    value |= (uint32_t)(*(*buf)++) << shift;
+    return value;
+}
+
+// writes a little endian 4 byte number
+void putU32(uint8_t *buf, uint32_t value) {
+    for (int i = 0; i < 4; i++) {
+        buf[i] = value >> (8 * i);
+    }
+}
+
+// reads a little endian 4 byte number
+uint32_t getU32(const uint8_t *buf) {
+    return buf[0] | buf[1] << 8 | buf[2] << 16 | (uint32_t)buf[3] << 24;
+}
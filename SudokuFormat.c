@@ -0,0 +1,72 @@
+#include "SudokuDefinitions.h"
+#include <ctype.h>
+#include <stdbool.h>
+#include <string.h>
+
+// boardSize - int value holding the number of rows, columns, and digits in the board (9, 16, or 25)
+extern int boardSize;
+
+// SudokuFormat - contains the following functions to read and write boards as single-line text
+// a board is written row by row as boardSize * boardSize characters: '.' or '0' for an empty cell,
+// '1'-'9' for the digits 1-9, and 'A'-'P' for the digits 10-25
+bool parseBoard(const char *str, int (*grid)[MAX_SIZE], bool (*given)[MAX_SIZE]); // reads a board, marking every filled cell as a given
+void formatBoard(int (*grid)[MAX_SIZE], char *str);                               // writes a board (str needs boardSize * boardSize + 1 characters)
+int parseDigit(char c);                                                           // converts a character to its digit (-1 if not a digit)
+char formatDigit(int num);                                                        // converts a digit to its character
+
+// reads a board, marking every filled cell as a given
+bool parseBoard(const char *str, int (*grid)[MAX_SIZE], bool (*given)[MAX_SIZE]) {
+    //the board must have exactly one character per cell
+    if ((int)strlen(str) != boardSize * boardSize) {
+        return false;
+    }
+
+    for (int row = 0; row < boardSize; row++) {
+        for (int col = 0; col < boardSize; col++) {
+            int num = parseDigit(str[row * boardSize + col]);
+            if (num < 0) {
+                return false;
+            }
+            grid[row][col] = num;
+            if (given != NULL) {
+                given[row][col] = num != EMPTY;
+            }
+        }
+    }
+    return true;
+}
+
+// writes a board (str needs boardSize * boardSize + 1 characters)
+void formatBoard(int (*grid)[MAX_SIZE], char *str) {
+    for (int row = 0; row < boardSize; row++) {
+        for (int col = 0; col < boardSize; col++) {
+            *str++ = formatDigit(grid[row][col]);
+        }
+    }
+    *str = '\0';
+}
+
+// converts a character to its digit (-1 if not a digit)
+int parseDigit(char c) {
+    int num;
+    if (c == '.' || c == '0') {
+        num = EMPTY;
+    } else if (c >= '1' && c <= '9') {
+        num = c - '0';
+    } else if (isalpha((unsigned char)c)) {
+        num = toupper((unsigned char)c) - 'A' + 10;
+    } else {
+        return -1;
+    }
+
+    //make sure the digit fits on the board
+    return num <= boardSize ? num : -1;
+}
+
+// converts a digit to its character
+char formatDigit(int num) {
+    if (num == EMPTY) {
+        return '.';
+    }
+    return num < 10 ? '0' + num : 'A' + num - 10;
+}
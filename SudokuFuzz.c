@@ -0,0 +1,676 @@
+#include "SudokuDefinitions.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// boardSize - int value holding the number of rows, columns, and digits in the board (9, 16, or 25)
+extern int boardSize;
+// boxSize - int value holding the number of rows and columns in each box (3, 4, or 5)
+extern int boxSize;
+// grid - 2D int array to hold contents of each cell in the sudoku board (only the first boardSize rows and columns are used)
+extern int grid[MAX_SIZE][MAX_SIZE];
+// given - 2D boolean array to hold the type of each cell (true = a given number, false = a penciled number)
+extern bool given[MAX_SIZE][MAX_SIZE];
+
+// LegacyBoard - a board and its states, as the original solver kept them in globals
+typedef struct {
+    int grid[MAX_SIZE][MAX_SIZE];
+    bool given[MAX_SIZE][MAX_SIZE];
+    bool correct[MAX_SIZE][MAX_SIZE];
+    int solved;
+    long long nodes; // cells tried by the legacy solver (it gives up past FUZZ_NODE_BUDGET)
+} LegacyBoard;
+
+// FuzzStats - results of one operation over every board
+typedef struct {
+    const char *name;     // operation (count, mark, solve, deep, cands, incr, or variant)
+    int mismatches;       // boards where the kernel and the legacy solver disagreed
+    int skipped;          // boards the legacy solver gave up on
+    long long nodes;      // cells tried by the kernel
+    long long oldNodes;   // cells tried by the legacy solver
+    double seconds;       // time taken by the kernel
+    double oldSeconds;    // time taken by the legacy solver
+} FuzzStats;
+
+// SudokuFuzz - contains the following functions to check the kernels, the incremental store, and the variant solver against the original backtracker on random boards
+int runFuzz(int numBoards, unsigned int seed, char *baselinePath);                 // compares the kernels to the legacy solver and checks the baseline (returns 1 on any failure)
+void fuzzCheck(FuzzStats *stats, int op, LegacyBoard *start, int kind, LegacyBoard *old, LegacyBoard *new, bool timing, bool *skip); // runs one operation with both solvers and compares the results (only times the kernel on a timing run)
+void genFuzzBoard(LegacyBoard *b, int kind);                                       // fills a random board of the given kind (see FUZZ_KINDS)
+void genFuzzSolution(int (*solution)[MAX_SIZE]);                                   // fills a random complete solution
+bool sameBoards(LegacyBoard *a, LegacyBoard *b);                                   // checks if two boards have the same cells, correct cells, and solved state
+bool isFuzzSolution(LegacyBoard *b);                                               // checks that every cell that isn't given holds a number its peers allow
+void reportMismatch(FuzzStats *stats, LegacyBoard *start, int kind, char *detail); // prints a board the kernel got wrong
+bool checkBaseline(char *path, unsigned int seed, int numBoards, FuzzStats *stats); // compares the kernel's nodes and times to a stored run, or stores this run
+double fuzzClock();                                                                // seconds on the monotonic clock
+double medianTime(double (*times)[FUZZ_OPS], int runs, int op);                    // median of an operation's times over the runs
+bool legacyGenSolution(LegacyBoard *b, int row, int col);                          // the original genSolution
+bool legacyMarkSolution(LegacyBoard *b, int row, int col);                         // the original markSolution
+void legacyGetNumSolutions(LegacyBoard *b, int row, int col, int *count, int max); // the original getNumSolutions
+bool legacyIsValidShallow(LegacyBoard *b, int row, int col, int num);              // the original isValidShallow
+bool legacyIsValidDeep(LegacyBoard *b, int row, int col, int num);                 // the original isValidDeep
+bool legacyGetCandidates(LegacyBoard *b, uint32_t (*candidates)[MAX_SIZE]);        // getCandidates on top of the original isValidDeep (returns false if there are no solutions)
+
+// names of the kinds of random boards
+const char *fuzzKinds[FUZZ_KINDS] = {"sparse", "dense", "pencil", "contradictory", "random"};
+
+// compares the kernels to the legacy solver and checks the baseline (returns 1 on any failure)
+int runFuzz(int numBoards, unsigned int seed, char *baselinePath) {
+    FuzzStats stats[FUZZ_OPS] = {{.name = "count"}, {.name = "mark"},  {.name = "solve"},  {.name = "deep"},
+                                 {.name = "cands"}, {.name = "incr"}, {.name = "variant"}};
+    LegacyBoard *start = malloc(sizeof(LegacyBoard));
+    LegacyBoard *old = malloc(sizeof(LegacyBoard));
+    LegacyBoard *new = malloc(sizeof(LegacyBoard));
+    bool *skips = malloc(sizeof(bool) * numBoards * FUZZ_OPS);
+
+    //the variant solver with no extra rules has to agree with the legacy solver too
+    variant = calloc(1, sizeof(Variant));
+    memset(variant->cageOf, -1, sizeof(variant->cageOf));
+    buildVariantTables();
+
+    //with a baseline the kernel is timed again on the same boards, and each operation keeps its median time (so one slow run can't fail the gate)
+    int runs = baselinePath != NULL ? FUZZ_TIME_RUNS : 1;
+    double times[FUZZ_TIME_RUNS][FUZZ_OPS];
+    for (int run = 0; run < runs; run++) {
+        FuzzStats timingStats[FUZZ_OPS] = {{0}};
+        FuzzStats *runStats = run == 0 ? stats : timingStats;
+
+        //every run starts from an empty incremental store, so the deep and incr checks do the same searches again
+        if (incremental != NULL) {
+            free(incremental->solutions);
+            free(incremental);
+            incremental = NULL;
+        }
+
+        //the same seed gives the same boards, so node counts can be compared between runs
+        srand(seed);
+        for (int i = 0; i < numBoards; i++) {
+            int kind = i % FUZZ_KINDS;
+            genFuzzBoard(start, kind);
+            for (int op = 0; op < FUZZ_OPS; op++) {
+                fuzzCheck(&runStats[op], op, start, kind, old, new, run > 0, &skips[i * FUZZ_OPS + op]);
+            }
+        }
+        for (int op = 0; op < FUZZ_OPS; op++) {
+            times[run][op] = runStats[op].seconds;
+        }
+    }
+    for (int op = 0; op < FUZZ_OPS; op++) {
+        stats[op].seconds = medianTime(times, runs, op);
+    }
+
+    //summary of each operation
+    int mismatches = 0;
+    printf("\n%d %dx%d boards (seed %u)\n", numBoards, boardSize, boardSize, seed);
+    printf("op      mismatches  skipped   kernel nodes   legacy nodes   kernel ms   legacy ms   speedup\n");
+    for (int op = 0; op < FUZZ_OPS; op++) {
+        FuzzStats *s = &stats[op];
+        printf("%-7s %10d %8d %14lld %14lld %11.3f %11.3f %8.1fx\n", s->name, s->mismatches, s->skipped, s->nodes, s->oldNodes,
+               s->seconds * 1000, s->oldSeconds * 1000, s->seconds > 0 ? s->oldSeconds / s->seconds : 0.0);
+        mismatches += s->mismatches;
+    }
+
+    bool regressed = baselinePath != NULL && !checkBaseline(baselinePath, seed, numBoards, stats);
+    free(start);
+    free(old);
+    free(new);
+    free(skips);
+    free(variant->combos);
+    free(variant);
+    variant = NULL;
+
+    if (mismatches > 0) {
+        printf("\nFAILED: the kernels disagreed with the legacy solver on %d checks.\n", mismatches);
+    }
+    return mismatches > 0 || regressed ? 1 : 0;
+}
+
+// runs one operation with the legacy solver and the kernel on copies of a board and compares the results (only times the kernel on a timing run)
+void fuzzCheck(FuzzStats *stats, int op, LegacyBoard *start, int kind, LegacyBoard *old, LegacyBoard *new, bool timing, bool *skip) {
+    //draw every random argument, so the boards after a skipped check stay the same
+    int maxes[] = {1, 2, 10, 100, MAX_SOLUTIONS};
+    int max = maxes[rand() % 5];
+    int row = rand() % boardSize, col = rand() % boardSize, num = rand() % (boardSize + 1);
+
+    *old = *start;
+    *new = *start;
+    int oldResult = 0, newResult = 0;
+    uint32_t oldCandidates[MAX_SIZE][MAX_SIZE], newCandidates[MAX_SIZE][MAX_SIZE];
+    int known = -1;
+
+    //the incremental store counts the board first, then the board with a random given added
+    //(only into an empty cell and without breaking the rules, like the make mode, since a given that clashes can't only remove solutions)
+    bool edit = op == 5 && start->grid[row][col] == EMPTY && num != EMPTY && legacyIsValidShallow(start, row, col, num);
+    if (edit) {
+        old->grid[row][col] = num;
+        old->given[row][col] = true;
+    }
+
+    //the solver only ever runs on the givens (pencil marks are cleared first)
+    if (op == 2) {
+        for (int r = 0; r < boardSize; r++) {
+            for (int c = 0; c < boardSize; c++) {
+                if (!start->given[r][c]) {
+                    old->grid[r][c] = new->grid[r][c] = EMPTY;
+                }
+            }
+        }
+    }
+    //timing runs skip the legacy solver, and the boards it gave up on the first time
+    double t;
+    if (timing) {
+        if (*skip) {
+            return;
+        }
+    } else {
+        t = fuzzClock();
+        if (op == 0) {
+            legacyGetNumSolutions(old, 0, 0, &oldResult, max);
+        } else if (op == 1) {
+            oldResult = legacyMarkSolution(old, 0, 0);
+        } else if (op == 2) {
+            oldResult = legacyGenSolution(old, 0, 0);
+        } else if (op == 3) {
+            oldResult = legacyIsValidDeep(old, row, col, num);
+        } else if (op == 4) {
+            oldResult = legacyGetCandidates(old, oldCandidates);
+        } else {
+            legacyGetNumSolutions(old, 0, 0, &oldResult, max);
+        }
+        stats->oldSeconds += fuzzClock() - t;
+
+        //the legacy solver gives up on searches too big to compare
+        *skip = old->nodes > FUZZ_NODE_BUDGET;
+        if (*skip) {
+            stats->skipped++;
+            return;
+        }
+    }
+
+    //the deep check runs on the interactive board after a count, so it goes through the incremental store and its nogoods
+    if (op == 3) {
+        memcpy(grid, new->grid, sizeof(grid));
+        memcpy(given, new->given, sizeof(given));
+        int count = 0;
+        getNumSolutions(0, 0, &count, max);
+    }
+
+    long long nodes = kernelNodes;
+    t = fuzzClock();
+    if (op == 0) {
+        kernel->getNumSolutions(0, 0, new->grid, &newResult, max);
+    } else if (op == 1) {
+        newResult = kernel->markSolution(0, 0, new->grid, new->given, new->correct, &new->solved);
+    } else if (op == 2) {
+        newResult = kernel->genSolution(0, 0, new->grid, new->given);
+    } else if (op == 3) {
+        newResult = isValidDeep(row, col, num);
+
+        //a second check has to agree, from the nogood the first one learned if it found no solution
+        known = isValidDeep(row, col, num);
+        memcpy(new->grid, grid, sizeof(grid));
+    } else if (op == 4) {
+        newResult = kernel->getCandidates(new->grid, newCandidates);
+    } else if (op == 5) {
+        newResult = countIncremental(new->grid, max);
+        if (edit) {
+            new->grid[row][col] = num;
+            new->given[row][col] = true;
+            known = checkIncremental(new->grid);
+            newResult = countIncremental(new->grid, max);
+        }
+    } else {
+        variantGetNumSolutions(0, 0, new->grid, &newResult, max);
+    }
+    stats->seconds += fuzzClock() - t;
+    stats->nodes += kernelNodes - nodes;
+    stats->oldNodes += old->nodes;
+    if (timing) {
+        return;
+    }
+
+    //the kernel solves in another cell order, so on boards with several solutions it may fill in a different one
+    int wrongCell = -1;
+    for (int cell = 0; op == 4 && oldResult && cell < boardSize * boardSize && wrongCell < 0; cell++) {
+        if (start->grid[cell / boardSize][cell % boardSize] == EMPTY && oldCandidates[cell / boardSize][cell % boardSize] != newCandidates[cell / boardSize][cell % boardSize]) {
+            wrongCell = cell;
+        }
+    }
+    bool knownWrong = known >= 0 && known != (oldResult > 0);
+    if (oldResult != newResult || wrongCell >= 0 || knownWrong || !(sameBoards(old, new) || (op == 2 && newResult && isFuzzSolution(new)))) {
+        char detail[100];
+        if (op == 0 || op == 6) {
+            sprintf(detail, "max %d: legacy counted %d, %s counted %d", max, oldResult, stats->name, newResult);
+        } else if (op == 5) {
+            sprintf(detail, "max %d after %c%d %d: legacy counted %d, store counted %d and checked %d", max, row + 'A', col + 1, edit ? num : EMPTY,
+                    oldResult, newResult, known);
+        } else if (op == 3) {
+            sprintf(detail, "%c%d %d: legacy returned %d, isValidDeep returned %d then %d", row + 'A', col + 1, num, oldResult, newResult, known);
+        } else if (wrongCell >= 0) {
+            sprintf(detail, "%c%d: legacy allows %x, kernel allows %x", wrongCell / boardSize + 'A', wrongCell % boardSize + 1,
+                    oldCandidates[wrongCell / boardSize][wrongCell % boardSize], newCandidates[wrongCell / boardSize][wrongCell % boardSize]);
+        } else {
+            sprintf(detail, "legacy returned %d, kernel returned %d", oldResult, newResult);
+        }
+        reportMismatch(stats, start, kind, detail);
+    }
+}
+
+// fills a random board of the given kind (see FUZZ_KINDS)
+void genFuzzBoard(LegacyBoard *b, int kind) {
+    int solution[MAX_SIZE][MAX_SIZE];
+    genFuzzSolution(solution);
+
+    //denser boards for bigger sizes, where the legacy solver is too slow on sparse ones
+    int low = boardSize == 9 ? 20 : boardSize == 16 ? 55 : 75;
+    int density = kind == 0 ? low + rand() % 21 : kind == 4 ? 60 + rand() % 21 : 50 + rand() % 41;
+    if (density < low) {
+        density = low;
+    }
+
+    memset(b, 0, sizeof(LegacyBoard));
+    b->solved = NOT_CHECKED;
+    for (int row = 0; row < boardSize; row++) {
+        for (int col = 0; col < boardSize; col++) {
+            b->correct[row][col] = true;
+            if (rand() % 100 < density) {
+                //random boards ignore the solution, so they often break the rules
+                b->grid[row][col] = kind == 4 ? rand() % boardSize + 1 : solution[row][col];
+                b->given[row][col] = true;
+            } else if (kind == 2 && rand() % 3 == 0) {
+                //pencil marks, half of them right
+                b->grid[row][col] = rand() % 2 ? solution[row][col] : rand() % boardSize + 1;
+            }
+        }
+    }
+
+    //contradictory boards get a few givens changed, which may break the rules or just the solution
+    if (kind == 3) {
+        for (int i = 1 + rand() % 3; i > 0; i--) {
+            int row = rand() % boardSize, col = rand() % boardSize;
+            b->grid[row][col] = rand() % boardSize + 1;
+            b->given[row][col] = true;
+        }
+    }
+}
+
+// fills a random complete solution
+void genFuzzSolution(int (*solution)[MAX_SIZE]) {
+    //shuffle the numbers, the rows within each band, and the columns within each stack of a pattern solution
+    int nums[MAX_SIZE], rows[MAX_SIZE], cols[MAX_SIZE];
+    for (int i = 0; i < boardSize; i++) {
+        nums[i] = i + 1;
+        rows[i] = i;
+        cols[i] = i;
+    }
+    for (int i = boardSize - 1; i > 0; i--) {
+        int j = rand() % (i + 1);
+        int swap = nums[i];
+        nums[i] = nums[j];
+        nums[j] = swap;
+    }
+    for (int i = 0; i < boardSize; i++) {
+        int j = i / boxSize * boxSize + rand() % boxSize;
+        int swap = rows[i];
+        rows[i] = rows[j];
+        rows[j] = swap;
+        j = i / boxSize * boxSize + rand() % boxSize;
+        swap = cols[i];
+        cols[i] = cols[j];
+        cols[j] = swap;
+    }
+
+    for (int row = 0; row < boardSize; row++) {
+        for (int col = 0; col < boardSize; col++) {
+            int r = rows[row], c = cols[col];
+            solution[row][col] = nums[(r * boxSize + r / boxSize + c) % boardSize];
+        }
+    }
+}
+
+// checks if two boards have the same cells, correct cells, and solved state
+bool sameBoards(LegacyBoard *a, LegacyBoard *b) {
+    for (int row = 0; row < boardSize; row++) {
+        for (int col = 0; col < boardSize; col++) {
+            if (a->grid[row][col] != b->grid[row][col] || a->correct[row][col] != b->correct[row][col]) {
+                return false;
+            }
+        }
+    }
+    return a->solved == b->solved;
+}
+
+// checks that every cell that isn't given holds a number its peers allow
+bool isFuzzSolution(LegacyBoard *b) {
+    for (int row = 0; row < boardSize; row++) {
+        for (int col = 0; col < boardSize; col++) {
+            if (!b->given[row][col] && (b->grid[row][col] == EMPTY || !legacyIsValidShallow(b, row, col, b->grid[row][col]))) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// prints a board the kernel got wrong
+void reportMismatch(FuzzStats *stats, LegacyBoard *start, int kind, char *detail) {
+    stats->mismatches++;
+    if (stats->mismatches > FUZZ_REPORTS) {
+        return;
+    }
+
+    //givens and pencil marks on separate lines, so the board can be pasted back in
+    char givens[MAX_SIZE * MAX_SIZE + 1], marks[MAX_SIZE * MAX_SIZE + 1];
+    for (int cell = 0; cell < boardSize * boardSize; cell++) {
+        int row = cell / boardSize, col = cell % boardSize;
+        givens[cell] = start->given[row][col] ? formatDigit(start->grid[row][col]) : '.';
+        marks[cell] = start->given[row][col] ? '.' : formatDigit(start->grid[row][col]);
+    }
+    givens[boardSize * boardSize] = marks[boardSize * boardSize] = '\0';
+    printf("mismatch in %s on a %s board (%s)\n  givens %s\n  pencil %s\n", stats->name, fuzzKinds[kind], detail, givens, marks);
+}
+
+// compares the kernel's nodes and times to a stored run, or stores this run
+bool checkBaseline(char *path, unsigned int seed, int numBoards, FuzzStats *stats) {
+    FILE *file = fopen(path, "r");
+    if (file == NULL) {
+        //no baseline yet, this run becomes the baseline
+        file = fopen(path, "w");
+        if (file == NULL) {
+            perror(path);
+            return false;
+        }
+        fprintf(file, "fuzz %d %u %d\n", boardSize, seed, numBoards);
+        for (int op = 0; op < FUZZ_OPS; op++) {
+            fprintf(file, "%s %lld %.6f\n", stats[op].name, stats[op].nodes, stats[op].seconds);
+        }
+        fclose(file);
+        printf("\nStored the baseline in %s.\n", path);
+        return true;
+    }
+
+    //the node counts only mean something for the same boards
+    int size, boards;
+    unsigned int baseSeed;
+    if (fscanf(file, "fuzz %d %u %d", &size, &baseSeed, &boards) != 3 || size != boardSize || baseSeed != seed || boards != numBoards) {
+        printf("\nThe baseline in %s was not recorded with --size %d --seed %u --fuzz %d.\n", path, boardSize, seed, numBoards);
+        fclose(file);
+        return false;
+    }
+
+    //nodes are exact per operation, times only fail in total since the short operations are too noisy on their own
+    bool passed = true;
+    double seconds = 0, baseSeconds = 0;
+    printf("\nop      nodes vs baseline   time vs baseline\n");
+    for (int op = 0; op < FUZZ_OPS; op++) {
+        char name[16];
+        long long nodes;
+        double opSeconds;
+        if (fscanf(file, "%15s %lld %lf", name, &nodes, &opSeconds) != 3 || strcmp(name, stats[op].name) != 0) {
+            printf("The baseline in %s is missing %s.\n", path, stats[op].name);
+            passed = false;
+            continue;
+        }
+
+        double nodeRatio = nodes > 0 ? (double)stats[op].nodes / nodes : 1;
+        bool nodesOk = nodeRatio <= 1 + FUZZ_NODE_SLACK / 100.0;
+        printf("%-7s %16.3fx%s %17.3fx\n", stats[op].name, nodeRatio, nodesOk ? " " : "!", opSeconds > 0 ? stats[op].seconds / opSeconds : 1);
+        passed = passed && nodesOk;
+        seconds += stats[op].seconds;
+        baseSeconds += opSeconds;
+    }
+    double timeRatio = baseSeconds > 0 ? seconds / baseSeconds : 1;
+    bool timeOk = timeRatio <= 1 + FUZZ_TIME_SLACK / 100.0;
+    printf("total   %16s  %17.3fx%s\n", "", timeRatio, timeOk ? "" : "!");
+    passed = passed && timeOk;
+    fclose(file);
+
+    if (!passed) {
+        printf("\nFAILED: the kernels regressed past the baseline (nodes +%d%% per operation and median time +%d%% in total allowed).\n", FUZZ_NODE_SLACK,
+               FUZZ_TIME_SLACK);
+    }
+    return passed;
+}
+
+// seconds on the monotonic clock
+double fuzzClock() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+// median of an operation's times over the runs
+double medianTime(double (*times)[FUZZ_OPS], int runs, int op) {
+    //insertion sort, there are only a few runs
+    double sorted[FUZZ_TIME_RUNS];
+    for (int i = 0; i < runs; i++) {
+        int j = i;
+        for (; j > 0 && sorted[j - 1] > times[i][op]; j--) {
+            sorted[j] = sorted[j - 1];
+        }
+        sorted[j] = times[i][op];
+    }
+    return sorted[runs / 2];
+}
+
+// the original genSolution
+bool legacyGenSolution(LegacyBoard *b, int row, int col) {
+    //give up on searches too big to compare
+    if (++b->nodes > FUZZ_NODE_BUDGET) {
+        return false;
+    }
+
+    //base case: reached the end of the board -> solved
+    if (row == boardSize - 1 && col == boardSize) {
+        return true;
+    }
+
+    //if column overflow, move to next row
+    if (col == boardSize) {
+        col = 0;
+        row += 1;
+    }
+
+    if (!b->given[row][col]) {
+        //if cell is empty, try each number
+        for (int i = 0; i < boardSize; i++) {
+            //check if setting this will immediately break the puzzle
+            if (legacyIsValidShallow(b, row, col, i + 1)) {
+                //assume temporarily this number is right
+                b->grid[row][col] = i + 1;
+
+                //recursively check the next cell
+                if (legacyGenSolution(b, row, col + 1)) {
+                    //if found a solution, stop the recursion
+                    return true;
+                }
+            }
+        }
+
+        //if didn't find a solution, reset the cell
+        b->grid[row][col] = EMPTY;
+
+        //return to parent for backtracking
+        return false;
+    } else {
+        //if cell is already filled, skip it
+        return legacyGenSolution(b, row, col + 1);
+    }
+}
+
+// the original markSolution
+bool legacyMarkSolution(LegacyBoard *b, int row, int col) {
+    //give up on searches too big to compare
+    if (++b->nodes > FUZZ_NODE_BUDGET) {
+        return false;
+    }
+
+    //base case: reached the end of the board -> solved
+    if (row == boardSize - 1 && col == boardSize) {
+        return true;
+    }
+
+    //if column overflow, move to next row
+    if (col == boardSize) {
+        col = 0;
+        row += 1;
+    }
+
+    if (!b->given[row][col]) {
+        //save initial number
+        int prev = b->grid[row][col];
+
+        //if cell is not given, try each number
+        for (int i = 0; i < boardSize; i++) {
+            //check if setting this will immediately break the puzzle
+            if (legacyIsValidShallow(b, row, col, i + 1)) {
+                //assume temporarily this number is right
+                b->grid[row][col] = i + 1;
+
+                //recursively check the next cell
+                if (legacyMarkSolution(b, row, col + 1)) {
+                    //if found a solution, compare to the initial value
+                    if (prev != i + 1) {
+                        //if not correct, update correct array and revert cell
+                        b->correct[row][col] = false;
+                        b->solved = WRONG;
+                    }
+                    b->grid[row][col] = prev;
+                    return true;
+                }
+            }
+        }
+
+        //if didn't find a solution, reset the cell
+        b->grid[row][col] = prev;
+
+        //return to parent for backtracking
+        return false;
+    } else {
+        //if cell is already filled, skip it
+        return legacyMarkSolution(b, row, col + 1);
+    }
+}
+
+// the original getNumSolutions
+void legacyGetNumSolutions(LegacyBoard *b, int row, int col, int *count, int max) {
+    //give up on searches too big to compare
+    if (++b->nodes > FUZZ_NODE_BUDGET) {
+        return;
+    }
+
+    //base case: reached the end of the board -> solved
+    if (row == boardSize - 1 && col == boardSize) {
+        //increase solution counter
+        *count += 1;
+        return;
+    }
+
+    //if column overflow, move to next row
+    if (col == boardSize) {
+        col = 0;
+        row += 1;
+    }
+
+    if (b->grid[row][col] == EMPTY) {
+        //if cell is empty, try each number
+        for (int i = 0; i < boardSize; i++) {
+            //check if setting this will immediately break the puzzle
+            if (legacyIsValidShallow(b, row, col, i + 1)) {
+                //assume temporarily this number is right
+                b->grid[row][col] = i + 1;
+
+                //recursively check the next cell
+                legacyGetNumSolutions(b, row, col + 1, count, max);
+
+                //reset the cell
+                b->grid[row][col] = EMPTY;
+
+                //if reached the maximum solution count, stop the recursion
+                if (*count >= max) {
+                    return;
+                }
+            }
+        }
+    } else {
+        //if cell is already filled, skip it
+        legacyGetNumSolutions(b, row, col + 1, count, max);
+    }
+}
+
+// the original isValidShallow
+bool legacyIsValidShallow(LegacyBoard *b, int row, int col, int num) {
+    //check for duplicate values in the same row and column
+    for (int i = 0; i < boardSize; i++) {
+        if (col != i && b->grid[row][i] == num)
+            return false;
+        if (row != i && b->grid[i][col] == num) {
+            return false;
+        }
+    }
+
+    //calculate the first row and column in the cell's box
+    int startRow = row / boxSize * boxSize;
+    int startCol = col / boxSize * boxSize;
+
+    //check for duplicates in the same box
+    for (int r = 0; r < boxSize; r++) {
+        for (int c = 0; c < boxSize; c++) {
+            if (!(startRow + r == row && startCol + c == col) && b->grid[startRow + r][startCol + c] == num)
+                return false;
+        }
+    }
+
+    //cell passed shallow tests
+    return true;
+}
+
+// the original isValidDeep
+bool legacyIsValidDeep(LegacyBoard *b, int row, int col, int num) {
+    //do shallow check first
+    if (!legacyIsValidShallow(b, row, col, num))
+        return false;
+
+    //do deep check if passed shallow check
+    //save current value of the grid
+    int previous = b->grid[row][col];
+
+    //assume temporarily the cell was updated
+    b->grid[row][col] = num;
+
+    //verify there is at least one solution with this assumption
+    int count = 0;
+    legacyGetNumSolutions(b, 0, 0, &count, 1); //will return 0 or 1 because set max of 1
+
+    //reset the grid value
+    b->grid[row][col] = previous;
+
+    //return true if there was at least one solution
+    return count == 1;
+}
+
+// getCandidates on top of the original isValidDeep (returns false if there are no solutions)
+bool legacyGetCandidates(LegacyBoard *b, uint32_t (*candidates)[MAX_SIZE]) {
+    bool any = false;
+    for (int row = 0; row < boardSize; row++) {
+        for (int col = 0; col < boardSize; col++) {
+            candidates[row][col] = 0;
+            for (int num = 1; num <= boardSize && b->grid[row][col] == EMPTY; num++) {
+                if (legacyIsValidDeep(b, row, col, num)) {
+                    candidates[row][col] |= 1u << (num - 1);
+                    any = true;
+                }
+            }
+        }
+    }
+
+    //a full board has no cells to try, so it only needs the count
+    if (!any) {
+        int count = 0;
+        legacyGetNumSolutions(b, 0, 0, &count, 1);
+        any = count > 0;
+    }
+    return any;
+}
@@ -0,0 +1,774 @@
+#include "SudokuDefinitions.h"
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// boardSize - int value holding the number of rows, columns, and digits in the board (9, 16, or 25)
+extern int boardSize;
+// boxSize - int value holding the number of rows and columns in each box (3, 4, or 5)
+extern int boxSize;
+
+// Grader - the units and peers of each cell for the board size being graded (built once, then only read by the workers)
+typedef struct {
+    int units[3 * MAX_SIZE][MAX_SIZE];               // cells of each row, then each column, then each box (box cells in reading order)
+    int cellUnits[MAX_SIZE * MAX_SIZE][3];           // row, column, and box unit of each cell
+    int peers[MAX_SIZE * MAX_SIZE][GRADE_MAX_PEERS]; // other cells sharing a unit with each cell
+    int numPeers;                                    // number of peers of every cell
+    uint64_t peerBits[MAX_SIZE * MAX_SIZE][GRADE_CELL_WORDS]; // peers of each cell as a bitset (checks a cell against a group of cells at once)
+    int numWords;                                    // words of a bitset of cells used for the board size
+    uint32_t full;                                   // bit of every number
+} Grader;
+
+// GradeState - candidates of a board being solved the way a person would (kept on the stack, nothing is allocated per step)
+typedef struct {
+    uint32_t cands[MAX_SIZE * MAX_SIZE];  // numbers each empty cell can still take, one bit per number (0 once filled)
+    int nums[MAX_SIZE * MAX_SIZE];        // number in each cell (EMPTY if not filled yet)
+    int numEmpty;                         // number of cells left to fill
+    bool broken;                          // set once a cell or unit runs out of candidates (the board has no solution)
+} GradeState;
+
+// GradeTechnique - one human solving technique, in the order they are tried
+typedef struct {
+    const char *name;                     // name printed as the hardest technique
+    int weight;                           // score added for each deduction the technique makes
+    int (*apply)(GradeState *s);          // applies the technique (returns the number of deductions, 0 if it doesn't fit)
+} GradeTechnique;
+
+// GradeBatch - a chunk of boards graded in parallel and printed in input order
+typedef struct {
+    char (*lines)[MAX_SIZE * MAX_SIZE + 64]; // boards of the chunk, one per line
+    int *hardest;                            // index of the hardest technique each board needed (or a GRADE_ error)
+    int *scores;                             // score of each board
+    int numLines;                            // number of boards in the chunk
+    int next;                                // next board for a worker to take (taken atomically)
+} GradeBatch;
+
+// grader - unit and peer tables (NULL until the first board is graded)
+Grader *grader = NULL;
+
+// SudokuGrader - contains the following functions to grade boards by the hardest human technique needed to solve them
+int runGrade(char *path, int numThreads);                 // grades every board in a file (one per line) in parallel and prints the results
+void *gradeBoards(void *arg);                             // thread that grades boards of a batch until none are left
+void buildGrader();                                       // fills in the unit and peer tables for the board size
+int gradeBoard(int (*clues)[MAX_SIZE], int *score);       // solves a board with the techniques (returns the hardest one needed, or a GRADE_ error)
+void placeNumber(GradeState *s, int cell, int num);       // fills a cell and removes the number from its peers
+bool removeCandidates(GradeState *s, int cell, uint32_t mask); // removes numbers from a cell's candidates (returns true if any were there)
+bool seesCell(int a, int b);                              // checks if two different cells share a unit
+bool seesAny(int cell, uint64_t *cells);                  // checks if a cell shares a unit with any cell of a bitset
+bool nextCombination(int *picks, int k, int num);         // steps to the next choice of k of num items (returns false after the last)
+int hiddenSingles(GradeState *s);                         // fills the numbers with only one place left in a unit
+int nakedSingles(GradeState *s);                          // fills the cells with only one candidate left
+int lockedCandidates(GradeState *s);                      // removes a number from a line or box when the other confines it to their crossing
+int nakedPairs(GradeState *s);                            // removes the numbers of two cells that only take those two from the rest of their unit
+int hiddenPairs(GradeState *s);                           // removes the other candidates of two cells that are the only places for two numbers
+int nakedTriples(GradeState *s);                          // nakedPairs with three cells
+int hiddenTriples(GradeState *s);                         // hiddenPairs with three cells
+int xWings(GradeState *s);                                // removes a number from two columns when two rows only have it there (and the other way around)
+int swordfish(GradeState *s);                             // xWings with three rows or columns
+int coloring(GradeState *s);                              // follows the chains of cells that are a number's only two places in a unit
+int xyChains(GradeState *s);                              // follows the chains of cells with two candidates each
+int nakedSubsets(GradeState *s, int k);                   // removes the numbers of k cells that only take those k numbers from the rest of their unit
+int hiddenSubsets(GradeState *s, int k);                  // removes the other candidates of k cells that are the only places for k numbers
+int fish(GradeState *s, int k);                           // removes a number from k columns (rows) when k rows (columns) only have it there
+
+// techniques - every technique the grader knows, easiest first (the last one stands for boards they can't solve)
+const GradeTechnique techniques[] = {
+    {"hidden-single", 1, hiddenSingles},
+    {"naked-single", 2, nakedSingles},
+    {"locked-candidates", 5, lockedCandidates},
+    {"naked-pair", 10, nakedPairs},
+    {"hidden-pair", 15, hiddenPairs},
+    {"naked-triple", 20, nakedTriples},
+    {"hidden-triple", 25, hiddenTriples},
+    {"x-wing", 30, xWings},
+    {"swordfish", 40, swordfish},
+    {"coloring", 50, coloring},
+    {"xy-chain", 60, xyChains},
+    {"guess", 100, NULL},
+};
+
+// grades every board in a file (one per line) in parallel and prints the results
+int runGrade(char *path, int numThreads) {
+    FILE *file = strcmp(path, "-") == 0 ? stdin : fopen(path, "r");
+    if (file == NULL) {
+        perror(path);
+        return 1;
+    }
+
+    buildGrader();
+    int numTechniques = sizeof(techniques) / sizeof(techniques[0]);
+    long long numHardest[sizeof(techniques) / sizeof(techniques[0])] = {0};
+    long long numBoards = 0;
+
+    GradeBatch batch;
+    batch.lines = malloc(sizeof(*batch.lines) * GRADE_CHUNK);
+    batch.hardest = malloc(sizeof(int) * GRADE_CHUNK);
+    batch.scores = malloc(sizeof(int) * GRADE_CHUNK);
+    pthread_t *threads = malloc(sizeof(pthread_t) * numThreads);
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    //stream the boards a chunk at a time so whole generator runs can be piped through
+    bool more = true;
+    while (more) {
+        batch.numLines = 0;
+        batch.next = 0;
+        while (batch.numLines < GRADE_CHUNK && (more = fgets(batch.lines[batch.numLines], sizeof(*batch.lines), file) != NULL)) {
+            char *line = batch.lines[batch.numLines];
+            line[strcspn(line, "\r\n")] = '\0';
+            if (line[0] != '\0' && line[0] != '#') {
+                batch.numLines++;
+            }
+        }
+
+        int numStarted = numThreads < batch.numLines ? numThreads : batch.numLines;
+        for (int i = 0; i < numStarted; i++) {
+            pthread_create(&threads[i], NULL, gradeBoards, &batch);
+        }
+        for (int i = 0; i < numStarted; i++) {
+            pthread_join(threads[i], NULL);
+        }
+
+        //print in input order so the output lines up with the file
+        for (int i = 0; i < batch.numLines; i++) {
+            int hardest = batch.hardest[i];
+            if (hardest == GRADE_INVALID) {
+                printf("error invalid board\n");
+            } else if (hardest == GRADE_NO_SOLUTION) {
+                printf("error no solution\n");
+            } else if (hardest == GRADE_NOT_UNIQUE) {
+                printf("error not unique\n");
+            } else {
+                printf("%s %s %d\n", batch.lines[i], techniques[hardest].name, batch.scores[i]);
+                numHardest[hardest]++;
+                numBoards++;
+            }
+        }
+        fflush(stdout);
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double seconds = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+    if (numBoards > 0) {
+        fprintf(stderr, "Graded %lld boards in %.3f seconds on %d threads (%.0f per second).\n", numBoards, seconds, numThreads, numBoards / seconds);
+        for (int i = 0; i < numTechniques; i++) {
+            if (numHardest[i] > 0) {
+                fprintf(stderr, "%-18s %10lld %6.1f%%\n", techniques[i].name, numHardest[i], numHardest[i] * 100.0 / numBoards);
+            }
+        }
+    }
+
+    free(batch.lines);
+    free(batch.hardest);
+    free(batch.scores);
+    free(threads);
+    if (file != stdin) {
+        fclose(file);
+    }
+    return 0;
+}
+
+// thread that grades boards of a batch until none are left
+void *gradeBoards(void *arg) {
+    GradeBatch *batch = arg;
+    int clues[MAX_SIZE][MAX_SIZE];
+    int i;
+    while ((i = __atomic_fetch_add(&batch->next, 1, __ATOMIC_RELAXED)) < batch->numLines) {
+        batch->scores[i] = 0;
+        if (!parseBoard(batch->lines[i], clues, NULL)) {
+            batch->hardest[i] = GRADE_INVALID;
+        } else {
+            batch->hardest[i] = gradeBoard(clues, &batch->scores[i]);
+        }
+    }
+    return NULL;
+}
+
+// fills in the unit and peer tables for the board size
+void buildGrader() {
+    if (grader == NULL) {
+        grader = calloc(1, sizeof(Grader));
+    }
+    grader->full = (uint32_t)((1ULL << boardSize) - 1);
+
+    for (int cell = 0; cell < boardSize * boardSize; cell++) {
+        int row = cell / boardSize;
+        int col = cell % boardSize;
+        int box = row / boxSize * boxSize + col / boxSize;
+        int inBox = row % boxSize * boxSize + col % boxSize;
+        grader->units[row][col] = cell;
+        grader->units[boardSize + col][row] = cell;
+        grader->units[2 * boardSize + box][inBox] = cell;
+        grader->cellUnits[cell][0] = row;
+        grader->cellUnits[cell][1] = boardSize + col;
+        grader->cellUnits[cell][2] = 2 * boardSize + box;
+    }
+
+    //peers = every other cell sharing a row, column, or box
+    grader->numWords = (boardSize * boardSize + 63) / 64;
+    memset(grader->peerBits, 0, sizeof(grader->peerBits));
+    for (int cell = 0; cell < boardSize * boardSize; cell++) {
+        int numPeers = 0;
+        for (int other = 0; other < boardSize * boardSize; other++) {
+            bool shared = false;
+            for (int u = 0; u < 3; u++) {
+                shared |= grader->cellUnits[cell][u] == grader->cellUnits[other][u];
+            }
+            if (shared && other != cell) {
+                grader->peers[cell][numPeers++] = other;
+                grader->peerBits[cell][other / 64] |= 1ULL << (other % 64);
+            }
+        }
+        grader->numPeers = numPeers;
+    }
+}
+
+// solves a board with the techniques (returns the hardest one needed, or a GRADE_ error)
+int gradeBoard(int (*clues)[MAX_SIZE], int *score) {
+    GradeState s;
+    s.numEmpty = boardSize * boardSize;
+    s.broken = false;
+    for (int cell = 0; cell < boardSize * boardSize; cell++) {
+        s.cands[cell] = grader->full;
+        s.nums[cell] = EMPTY;
+    }
+
+    //givens that repeat a number leave no solution
+    for (int cell = 0; cell < boardSize * boardSize && !s.broken; cell++) {
+        int num = clues[cell / boardSize][cell % boardSize];
+        if (num != EMPTY) {
+            s.broken = !(s.cands[cell] >> (num - 1) & 1);
+            placeNumber(&s, cell, num);
+        }
+    }
+
+    //always go back to the easiest technique after a deduction, like a person would
+    int numTechniques = sizeof(techniques) / sizeof(techniques[0]) - 1;
+    int hardest = 0;
+    *score = 0;
+    while (s.numEmpty > 0 && !s.broken) {
+        int found = 0;
+        int technique = 0;
+        while (technique < numTechniques && (found = techniques[technique].apply(&s)) == 0) {
+            technique++;
+        }
+        if (technique == numTechniques) {
+            break;
+        }
+        *score += techniques[technique].weight * found;
+        hardest = technique > hardest ? technique : hardest;
+    }
+
+    if (s.broken) {
+        return GRADE_NO_SOLUTION;
+    }
+    if (s.numEmpty == 0) {
+        //every deduction holds in every solution, so a board the techniques fill has exactly one
+        return hardest;
+    }
+
+    //the techniques got stuck, so only a search can tell a hard board from a broken one
+    int count = lookupCache(clues, 2, NULL);
+    if (count < 0) {
+        count = 0;
+        kernel->getNumSolutions(0, 0, clues, &count, 2);
+        storeCache(clues, count, 2, NULL);
+    }
+    if (count != 1) {
+        return count == 0 ? GRADE_NO_SOLUTION : GRADE_NOT_UNIQUE;
+    }
+    *score += techniques[numTechniques].weight;
+    return numTechniques;
+}
+
+// fills a cell and removes the number from its peers
+void placeNumber(GradeState *s, int cell, int num) {
+    uint32_t bit = 1u << (num - 1);
+    s->nums[cell] = num;
+    s->cands[cell] = 0;
+    s->numEmpty--;
+    for (int i = 0; i < grader->numPeers; i++) {
+        removeCandidates(s, grader->peers[cell][i], bit);
+    }
+}
+
+// removes numbers from a cell's candidates (returns true if any were there)
+bool removeCandidates(GradeState *s, int cell, uint32_t mask) {
+    if ((s->cands[cell] & mask) == 0) {
+        return false;
+    }
+    s->cands[cell] &= ~mask;
+    if (s->cands[cell] == 0) {
+        s->broken = true;
+    }
+    return true;
+}
+
+// checks if two different cells share a unit
+bool seesCell(int a, int b) {
+    return grader->peerBits[a][b / 64] >> (b % 64) & 1;
+}
+
+// checks if a cell shares a unit with any cell of a bitset
+bool seesAny(int cell, uint64_t *cells) {
+    uint64_t shared = 0;
+    for (int i = 0; i < grader->numWords; i++) {
+        shared |= grader->peerBits[cell][i] & cells[i];
+    }
+    return shared != 0;
+}
+
+// steps to the next choice of k of num items (returns false after the last)
+bool nextCombination(int *picks, int k, int num) {
+    int i = k - 1;
+    while (i >= 0 && picks[i] == num - k + i) {
+        i--;
+    }
+    if (i < 0) {
+        return false;
+    }
+    picks[i]++;
+    for (int j = i + 1; j < k; j++) {
+        picks[j] = picks[j - 1] + 1;
+    }
+    return true;
+}
+
+// fills the numbers with only one place left in a unit
+int hiddenSingles(GradeState *s) {
+    int found = 0;
+    for (int unit = 0; unit < 3 * boardSize && !s->broken; unit++) {
+        //numbers seen once and more than once among the unit's candidates
+        uint32_t once = 0, twice = 0, placed = 0;
+        for (int i = 0; i < boardSize; i++) {
+            int cell = grader->units[unit][i];
+            twice |= once & s->cands[cell];
+            once |= s->cands[cell];
+            placed |= s->nums[cell] != EMPTY ? 1u << (s->nums[cell] - 1) : 0;
+        }
+        if ((once | placed) != grader->full) {
+            s->broken = true;
+            break;
+        }
+
+        for (uint32_t singles = once & ~twice; singles != 0; singles &= singles - 1) {
+            uint32_t bit = singles & -singles;
+            for (int i = 0; i < boardSize; i++) {
+                int cell = grader->units[unit][i];
+                if (s->cands[cell] & bit) {
+                    placeNumber(s, cell, __builtin_ctz(bit) + 1);
+                    found++;
+                    break;
+                }
+            }
+        }
+    }
+    return found;
+}
+
+// fills the cells with only one candidate left
+int nakedSingles(GradeState *s) {
+    int found = 0;
+    for (int cell = 0; cell < boardSize * boardSize && !s->broken; cell++) {
+        if (s->cands[cell] != 0 && (s->cands[cell] & (s->cands[cell] - 1)) == 0) {
+            placeNumber(s, cell, __builtin_ctz(s->cands[cell]) + 1);
+            found++;
+        }
+    }
+    return found;
+}
+
+// removes a number from a line or box when the other confines it to their crossing
+int lockedCandidates(GradeState *s) {
+    int found = 0;
+    for (int box = 0; box < boardSize; box++) {
+        int *boxCells = grader->units[2 * boardSize + box];
+
+        //each row, then each column, crossing the box
+        for (int line = 0; line < 2 * boxSize; line++) {
+            int kind = line < boxSize ? 0 : 1;
+            int unit = kind == 0 ? grader->cellUnits[boxCells[line * boxSize]][0] : grader->cellUnits[boxCells[line - boxSize]][1];
+
+            uint32_t crossing = 0, lineRest = 0, boxRest = 0;
+            for (int i = 0; i < boardSize; i++) {
+                int cell = grader->units[unit][i];
+                if (grader->cellUnits[cell][2] == 2 * boardSize + box) {
+                    crossing |= s->cands[cell];
+                } else {
+                    lineRest |= s->cands[cell];
+                }
+                if (grader->cellUnits[boxCells[i]][kind] != unit) {
+                    boxRest |= s->cands[boxCells[i]];
+                }
+            }
+
+            //pointing: the box only has the number on the line, so the rest of the line can't
+            //claiming: the line only has the number in the box, so the rest of the box can't
+            uint32_t pointing = crossing & ~boxRest & lineRest;
+            uint32_t claiming = crossing & ~lineRest & boxRest;
+            for (int i = 0; i < boardSize && pointing != 0; i++) {
+                int cell = grader->units[unit][i];
+                if (grader->cellUnits[cell][2] != 2 * boardSize + box) {
+                    removeCandidates(s, cell, pointing);
+                }
+            }
+            for (int i = 0; i < boardSize && claiming != 0; i++) {
+                if (grader->cellUnits[boxCells[i]][kind] != unit) {
+                    removeCandidates(s, boxCells[i], claiming);
+                }
+            }
+            found += (pointing != 0) + (claiming != 0);
+        }
+    }
+    return found;
+}
+
+// removes the numbers of two cells that only take those two from the rest of their unit
+int nakedPairs(GradeState *s) {
+    return nakedSubsets(s, 2);
+}
+
+// removes the other candidates of two cells that are the only places for two numbers
+int hiddenPairs(GradeState *s) {
+    return hiddenSubsets(s, 2);
+}
+
+// nakedPairs with three cells
+int nakedTriples(GradeState *s) {
+    return nakedSubsets(s, 3);
+}
+
+// hiddenPairs with three cells
+int hiddenTriples(GradeState *s) {
+    return hiddenSubsets(s, 3);
+}
+
+// removes a number from two columns when two rows only have it there (and the other way around)
+int xWings(GradeState *s) {
+    return fish(s, 2);
+}
+
+// xWings with three rows or columns
+int swordfish(GradeState *s) {
+    return fish(s, 3);
+}
+
+// removes the numbers of k cells that only take those k numbers from the rest of their unit
+int nakedSubsets(GradeState *s, int k) {
+    int found = 0;
+    for (int unit = 0; unit < 3 * boardSize; unit++) {
+        //only cells with 2 to k candidates can be part of the subset
+        int indexes[MAX_SIZE];
+        int num = 0;
+        for (int i = 0; i < boardSize; i++) {
+            int count = __builtin_popcount(s->cands[grader->units[unit][i]]);
+            if (count >= 2 && count <= k) {
+                indexes[num++] = i;
+            }
+        }
+        if (num < k) {
+            continue;
+        }
+
+        int picks[3] = {0, 1, 2};
+        do {
+            uint32_t nums = 0, members = 0;
+            for (int j = 0; j < k; j++) {
+                nums |= s->cands[grader->units[unit][indexes[picks[j]]]];
+                members |= 1u << indexes[picks[j]];
+            }
+            if (__builtin_popcount(nums) != k) {
+                continue;
+            }
+
+            bool changed = false;
+            for (int i = 0; i < boardSize; i++) {
+                if (!(members >> i & 1)) {
+                    changed |= removeCandidates(s, grader->units[unit][i], nums);
+                }
+            }
+            found += changed;
+        } while (nextCombination(picks, k, num));
+    }
+    return found;
+}
+
+// removes the other candidates of k cells that are the only places for k numbers
+int hiddenSubsets(GradeState *s, int k) {
+    int found = 0;
+    for (int unit = 0; unit < 3 * boardSize; unit++) {
+        //places of each number in the unit, one bit per index in the unit
+        uint32_t where[MAX_SIZE] = {0};
+        for (int i = 0; i < boardSize; i++) {
+            for (uint32_t cands = s->cands[grader->units[unit][i]]; cands != 0; cands &= cands - 1) {
+                where[__builtin_ctz(cands)] |= 1u << i;
+            }
+        }
+        uint32_t places[MAX_SIZE];
+        int nums[MAX_SIZE];
+        int num = 0;
+        for (int n = 0; n < boardSize; n++) {
+            int count = __builtin_popcount(where[n]);
+            if (count >= 2 && count <= k) {
+                places[num] = where[n];
+                nums[num++] = n;
+            }
+        }
+        if (num < k) {
+            continue;
+        }
+
+        int picks[3] = {0, 1, 2};
+        do {
+            uint32_t cover = 0, keep = 0;
+            for (int j = 0; j < k; j++) {
+                cover |= places[picks[j]];
+                keep |= 1u << nums[picks[j]];
+            }
+            if (__builtin_popcount(cover) != k) {
+                continue;
+            }
+
+            bool changed = false;
+            for (int i = 0; i < boardSize; i++) {
+                if (cover >> i & 1) {
+                    changed |= removeCandidates(s, grader->units[unit][i], grader->full & ~keep);
+                }
+            }
+            found += changed;
+        } while (nextCombination(picks, k, num));
+    }
+    return found;
+}
+
+// removes a number from k columns (rows) when k rows (columns) only have it there
+int fish(GradeState *s, int k) {
+    //places of each number along each row and column, in one pass over the cells
+    //(removals below only shrink the real places, so the fish found from these stay right)
+    uint32_t where[2][MAX_SIZE][MAX_SIZE];
+    memset(where, 0, sizeof(where));
+    for (int cell = 0; cell < boardSize * boardSize; cell++) {
+        int row = cell / boardSize, col = cell % boardSize;
+        for (uint32_t cands = s->cands[cell]; cands != 0; cands &= cands - 1) {
+            where[0][__builtin_ctz(cands)][row] |= 1u << col;
+            where[1][__builtin_ctz(cands)][col] |= 1u << row;
+        }
+    }
+
+    int found = 0;
+    for (int n = 0; n < boardSize; n++) {
+        uint32_t bit = 1u << n;
+        for (int kind = 0; kind < 2; kind++) {
+            //base lines are rows for kind 0, columns for kind 1
+            uint32_t places[MAX_SIZE];
+            int lines[MAX_SIZE];
+            int num = 0;
+            for (int line = 0; line < boardSize; line++) {
+                int count = __builtin_popcount(where[kind][n][line]);
+                if (count >= 2 && count <= k) {
+                    places[num] = where[kind][n][line];
+                    lines[num++] = line;
+                }
+            }
+            if (num < k) {
+                continue;
+            }
+
+            int picks[3] = {0, 1, 2};
+            do {
+                uint32_t cover = 0, base = 0;
+                for (int j = 0; j < k; j++) {
+                    cover |= places[picks[j]];
+                    base |= 1u << lines[picks[j]];
+                }
+                if (__builtin_popcount(cover) != k) {
+                    continue;
+                }
+
+                //the k base lines use up the cover lines' places for the number
+                bool changed = false;
+                for (int cross = 0; cross < boardSize; cross++) {
+                    for (int i = 0; i < boardSize && (cover >> cross & 1); i++) {
+                        if (!(base >> i & 1)) {
+                            changed |= removeCandidates(s, grader->units[(1 - kind) * boardSize + cross][i], bit);
+                        }
+                    }
+                }
+                found += changed;
+            } while (nextCombination(picks, k, num));
+        }
+    }
+    return found;
+}
+
+// follows the chains of cells that are a number's only two places in a unit
+int coloring(GradeState *s) {
+    for (int n = 0; n < boardSize; n++) {
+        uint32_t bit = 1u << n;
+
+        //the two places of the number in each unit that has exactly two (-1 = none)
+        int pairs[3 * MAX_SIZE][2];
+        for (int unit = 0; unit < 3 * boardSize; unit++) {
+            int count = 0;
+            for (int i = 0; i < boardSize; i++) {
+                int cell = grader->units[unit][i];
+                if (s->cands[cell] & bit) {
+                    if (count < 2) {
+                        pairs[unit][count] = cell;
+                    }
+                    count++;
+                }
+            }
+            if (count != 2) {
+                pairs[unit][0] = -1;
+            }
+        }
+
+        //color each chain of pairs with alternating colors, one of which holds the number
+        int component[MAX_SIZE * MAX_SIZE];
+        int color[MAX_SIZE * MAX_SIZE];
+        int chain[MAX_SIZE * MAX_SIZE];
+        uint64_t colorCells[2][GRADE_CELL_WORDS];
+        memset(component, -1, sizeof(int) * boardSize * boardSize);
+        for (int start = 0; start < boardSize * boardSize; start++) {
+            if (!(s->cands[start] & bit) || component[start] >= 0) {
+                continue;
+            }
+            int length = 0;
+            component[start] = start;
+            color[start] = 0;
+            chain[length++] = start;
+            for (int next = 0; next < length; next++) {
+                int cell = chain[next];
+                for (int u = 0; u < 3; u++) {
+                    int *pair = pairs[grader->cellUnits[cell][u]];
+                    if (pair[0] < 0 || (pair[0] != cell && pair[1] != cell)) {
+                        continue;
+                    }
+                    int other = pair[0] == cell ? pair[1] : pair[0];
+                    if (component[other] < 0) {
+                        component[other] = start;
+                        color[other] = 1 - color[cell];
+                        chain[length++] = other;
+                    }
+                }
+            }
+            if (length < 2) {
+                continue;
+            }
+            memset(colorCells, 0, sizeof(colorCells));
+            for (int i = 0; i < length; i++) {
+                colorCells[color[chain[i]]][chain[i] / 64] |= 1ULL << (chain[i] % 64);
+            }
+
+            //wrap: two cells of the same color see each other, so that color can't hold the number
+            int wrong = -1;
+            for (int i = 0; i < length && wrong < 0; i++) {
+                if (seesAny(chain[i], colorCells[color[chain[i]]])) {
+                    wrong = color[chain[i]];
+                }
+            }
+            if (wrong >= 0) {
+                for (int i = 0; i < length; i++) {
+                    if (color[chain[i]] == wrong) {
+                        removeCandidates(s, chain[i], bit);
+                    }
+                }
+                return 1;
+            }
+
+            //trap: a cell outside the chain that sees both colors can't hold the number
+            bool changed = false;
+            for (int cell = 0; cell < boardSize * boardSize; cell++) {
+                if (!(s->cands[cell] & bit) || component[cell] == start) {
+                    continue;
+                }
+                if (seesAny(cell, colorCells[0]) && seesAny(cell, colorCells[1])) {
+                    changed |= removeCandidates(s, cell, bit);
+                }
+            }
+            if (changed) {
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
+
+// follows the chains of cells with two candidates each
+int xyChains(GradeState *s) {
+    //every chain found is used on this pass, since removing candidates never makes a later chain wrong
+    int found = 0;
+    uint32_t reached[MAX_SIZE * MAX_SIZE];
+    int queueCells[2 * MAX_SIZE * MAX_SIZE];
+    uint32_t queueNums[2 * MAX_SIZE * MAX_SIZE];
+    int targets[GRADE_MAX_PEERS];
+
+    //cells with two candidates, so each step of a chain only looks at the bivalue peers
+    uint64_t bivalue[GRADE_CELL_WORDS] = {0};
+    for (int cell = 0; cell < boardSize * boardSize; cell++) {
+        if (__builtin_popcount(s->cands[cell]) == 2) {
+            bivalue[cell / 64] |= 1ULL << (cell % 64);
+        }
+    }
+
+    for (int start = 0; start < boardSize * boardSize; start++) {
+        if (__builtin_popcount(s->cands[start]) != 2) {
+            continue;
+        }
+        for (uint32_t ends = s->cands[start]; ends != 0; ends &= ends - 1) {
+            //only the start's peers with the end number can lose it, so without any there's no chain worth following
+            uint32_t end = ends & -ends;
+            int numTargets = 0;
+            for (int i = 0; i < grader->numPeers; i++) {
+                if (s->cands[grader->peers[start][i]] & end) {
+                    targets[numTargets++] = grader->peers[start][i];
+                }
+            }
+            if (numTargets == 0 || __builtin_popcount(s->cands[start]) != 2) {
+                continue;
+            }
+
+            //assume the start isn't the end number, then each bivalue peer of a cell can't be that cell's number
+            memset(reached, 0, sizeof(uint32_t) * boardSize * boardSize);
+            int length = 0;
+            queueCells[length] = start;
+            queueNums[length++] = s->cands[start] & ~end;
+            reached[start] = s->cands[start] & ~end;
+
+            for (int next = 0; next < length; next++) {
+                int cell = queueCells[next];
+                uint32_t bit = queueNums[next];
+                for (int w = 0; w < grader->numWords; w++) {
+                    for (uint64_t links = grader->peerBits[cell][w] & bivalue[w]; links != 0; links &= links - 1) {
+                        int peer = w * 64 + __builtin_ctzll(links);
+                        uint32_t cands = s->cands[peer];
+                        if (!(cands & bit) || __builtin_popcount(cands) != 2 || (reached[peer] & cands & ~bit)) {
+                            continue;
+                        }
+                        uint32_t forced = cands & ~bit;
+                        reached[peer] |= forced;
+                        queueCells[length] = peer;
+                        queueNums[length++] = forced;
+
+                        //the chain ends on the end number: either the start or this cell holds it, so cells seeing both can't
+                        if (forced == end && peer != start) {
+                            bool changed = false;
+                            for (int j = 0; j < numTargets; j++) {
+                                if (targets[j] != peer && seesCell(targets[j], peer)) {
+                                    changed |= removeCandidates(s, targets[j], end);
+                                }
+                            }
+                            found += changed;
+                        }
+                    }
+                }
+            }
+        }
+    }
+    return found;
+}
@@ -0,0 +1,230 @@
+#include "SudokuDefinitions.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+// boardSize - int value holding the number of rows, columns, and digits in the board (9, 16, or 25)
+extern int boardSize;
+
+// Incremental - what the interactive board's searches learned, kept between edits
+// adding a given can only remove solutions, so the solutions of a board stay usable for every board that adds givens to it
+// the nogoods are whole boards a search found no solution for, not the smaller sets of cells that caused the conflict,
+// so they only catch a board that repeats one of them or adds givens to it
+typedef struct {
+    int board[MAX_SIZE][MAX_SIZE];                  // board the stored solutions belong to
+    bool valid;                                     // true once a count has filled the store
+    bool complete;                                  // true if the store holds every solution of board (not just the first MAX_SOLUTIONS)
+    uint8_t *solutions;                             // stored solutions, one byte per cell
+    int numSolutions;                               // number of entries in solutions
+    int nogoods[INCREMENTAL_NOGOODS][MAX_SIZE * MAX_SIZE]; // filled cells of boards proven to have no solution (as cell * (MAX_SIZE + 1) + num)
+    int nogoodSizes[INCREMENTAL_NOGOODS];           // number of numbers in each nogood (0 = unused slot)
+    int nextNogood;                                 // slot the next nogood overwrites once the store is full
+} Incremental;
+
+// incremental - the interactive board's stored solutions and nogoods (NULL until the first count)
+Incremental *incremental = NULL;
+
+// SudokuIncremental - contains the following functions to reuse solutions and learned conflicts between consecutive edits of the board
+int countIncremental(int (*grid)[MAX_SIZE], int max);        // counts the solutions (up to the max) from the store if it can, with a recorded search otherwise
+int checkIncremental(int (*grid)[MAX_SIZE]);                 // decides whether the board has a solution without searching (returns 1 or 0, -1 if it can't tell)
+void learnNogood(int (*grid)[MAX_SIZE]);                     // records that the board's numbers have no solution together
+bool hasNogood(int (*grid)[MAX_SIZE]);                       // checks if the board holds every number of a learned nogood
+int candidatesIncremental(int (*grid)[MAX_SIZE], uint32_t (*candidates)[MAX_SIZE]);  // fills in the candidates from the store if it holds every solution (returns 1 or 0 for whether there are any, -1 if it can't tell)
+bool narrowStore(int (*grid)[MAX_SIZE]);                     // drops the stored solutions the board's new givens rule out (returns false if the board isn't covered)
+int addedGivens(int (*grid)[MAX_SIZE], int *added);          // lists the cells the board fills that the stored board doesn't (returns how many, -1 if the board isn't covered by the store)
+bool agreesWithGivens(int index, int (*grid)[MAX_SIZE], int *added, int numAdded); // checks if a stored solution puts the board's number in each added cell (the rest already agree)
+void recordSolution(int (*solution)[MAX_SIZE], void *data);  // visitor that adds each solution of a search to the store
+
+// counts the solutions (up to the max) from the store if it can, with a recorded search otherwise
+int countIncremental(int (*grid)[MAX_SIZE], int max) {
+    if (incremental == NULL) {
+        incremental = calloc(1, sizeof(Incremental));
+        incremental->solutions = malloc((size_t)MAX_SOLUTIONS * MAX_SIZE * MAX_SIZE);
+    }
+
+    //a board that only added givens keeps the solutions that agree with them
+    if (narrowStore(grid) && (incremental->complete || incremental->numSolutions >= max)) {
+        return incremental->numSolutions < max ? incremental->numSolutions : max;
+    }
+    if (hasNogood(grid)) {
+        return 0;
+    }
+
+    //another session (or another process) may have counted the board already
+    int cached = lookupCache(grid, max, NULL);
+    if (cached >= 0) {
+        return cached;
+    }
+
+    //search from scratch, keeping the solutions for the next edits
+    memcpy(incremental->board, grid, sizeof(incremental->board));
+    incremental->numSolutions = 0;
+    int count = 0;
+    kernel->forEachSolution(0, 0, grid, &count, max, recordSolution, NULL);
+    incremental->valid = true;
+    incremental->complete = count < max && count <= MAX_SOLUTIONS;
+    if (count == 0) {
+        learnNogood(grid);
+    }
+
+    //the first stored solution goes in the cache with the count
+    int solution[MAX_SIZE][MAX_SIZE];
+    for (int cell = 0; cell < boardSize * boardSize && count > 0; cell++) {
+        solution[cell / boardSize][cell % boardSize] = incremental->solutions[cell];
+    }
+    storeCache(grid, count, max, count > 0 ? solution : NULL);
+    return count;
+}
+
+// decides whether the board has a solution without searching (returns 1 or 0, -1 if it can't tell)
+int checkIncremental(int (*grid)[MAX_SIZE]) {
+    if (incremental == NULL) {
+        return -1;
+    }
+    if (hasNogood(grid)) {
+        return 0;
+    }
+
+    //any stored solution that agrees with the new givens is a solution of the board
+    int added[MAX_SIZE * MAX_SIZE];
+    int numAdded = addedGivens(grid, added);
+    if (numAdded < 0) {
+        return -1;
+    }
+    for (int i = 0; i < incremental->numSolutions; i++) {
+        if (agreesWithGivens(i, grid, added, numAdded)) {
+            return 1;
+        }
+    }
+
+    //every solution was stored and none agrees
+    return incremental->complete ? 0 : -1;
+}
+
+// records that the board's numbers have no solution together
+void learnNogood(int (*grid)[MAX_SIZE]) {
+    if (incremental == NULL) {
+        return;
+    }
+    int slot = incremental->nextNogood;
+    incremental->nextNogood = (slot + 1) % INCREMENTAL_NOGOODS;
+
+    int size = 0;
+    for (int row = 0; row < boardSize; row++) {
+        for (int col = 0; col < boardSize; col++) {
+            if (grid[row][col] != EMPTY) {
+                incremental->nogoods[slot][size++] = (row * boardSize + col) * (MAX_SIZE + 1) + grid[row][col];
+            }
+        }
+    }
+    incremental->nogoodSizes[slot] = size;
+}
+
+// checks if the board holds every number of a learned nogood
+bool hasNogood(int (*grid)[MAX_SIZE]) {
+    for (int slot = 0; slot < INCREMENTAL_NOGOODS; slot++) {
+        int size = incremental->nogoodSizes[slot];
+        bool holds = size > 0;
+        for (int i = 0; i < size && holds; i++) {
+            int cell = incremental->nogoods[slot][i] / (MAX_SIZE + 1);
+            holds = grid[cell / boardSize][cell % boardSize] == incremental->nogoods[slot][i] % (MAX_SIZE + 1);
+        }
+        if (holds) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// fills in the candidates from the store if it holds every solution (returns 1 or 0 for whether there are any, -1 if it can't tell)
+int candidatesIncremental(int (*grid)[MAX_SIZE], uint32_t (*candidates)[MAX_SIZE]) {
+    if (incremental == NULL || !narrowStore(grid) || !incremental->complete) {
+        return -1;
+    }
+
+    //the candidates of a cell are exactly the numbers the solutions put in it
+    for (int row = 0; row < boardSize; row++) {
+        for (int col = 0; col < boardSize; col++) {
+            candidates[row][col] = 0;
+        }
+    }
+    for (int i = 0; i < incremental->numSolutions; i++) {
+        uint8_t *solution = &incremental->solutions[(size_t)i * boardSize * boardSize];
+        for (int cell = 0; cell < boardSize * boardSize; cell++) {
+            if (grid[cell / boardSize][cell % boardSize] == EMPTY) {
+                candidates[cell / boardSize][cell % boardSize] |= 1u << (solution[cell] - 1);
+            }
+        }
+    }
+    return incremental->numSolutions > 0;
+}
+
+// drops the stored solutions the board's new givens rule out (returns false if the board isn't covered)
+bool narrowStore(int (*grid)[MAX_SIZE]) {
+    int added[MAX_SIZE * MAX_SIZE];
+    int numAdded = addedGivens(grid, added);
+    if (numAdded < 0) {
+        return false;
+    }
+
+    //keep the agreeing solutions in order at the front
+    int kept = 0;
+    size_t cells = boardSize * boardSize;
+    for (int i = 0; i < incremental->numSolutions && numAdded > 0; i++) {
+        if (agreesWithGivens(i, grid, added, numAdded)) {
+            memmove(&incremental->solutions[kept++ * cells], &incremental->solutions[i * cells], cells);
+        }
+    }
+    if (numAdded > 0) {
+        incremental->numSolutions = kept;
+        memcpy(incremental->board, grid, sizeof(incremental->board));
+    }
+    return true;
+}
+
+// lists the cells the board fills that the stored board doesn't (returns how many, -1 if the board isn't covered by the store)
+int addedGivens(int (*grid)[MAX_SIZE], int *added) {
+    if (!incremental->valid) {
+        return -1;
+    }
+
+    //the board has to keep every number of the stored board, removing or changing one can add solutions
+    int numAdded = 0;
+    for (int cell = 0; cell < boardSize * boardSize; cell++) {
+        int stored = incremental->board[cell / boardSize][cell % boardSize];
+        int num = grid[cell / boardSize][cell % boardSize];
+        if (stored != EMPTY && stored != num) {
+            return -1;
+        }
+        if (stored == EMPTY && num != EMPTY) {
+            added[numAdded++] = cell;
+        }
+    }
+    return numAdded;
+}
+
+// checks if a stored solution puts the board's number in each added cell (the rest already agree)
+bool agreesWithGivens(int index, int (*grid)[MAX_SIZE], int *added, int numAdded) {
+    uint8_t *solution = &incremental->solutions[(size_t)index * boardSize * boardSize];
+    for (int i = 0; i < numAdded; i++) {
+        if (solution[added[i]] != grid[added[i] / boardSize][added[i] % boardSize]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// visitor that adds each solution of a search to the store
+void recordSolution(int (*solution)[MAX_SIZE], void *data) {
+    (void)data;
+    if (incremental->numSolutions == MAX_SOLUTIONS) {
+        return;
+    }
+    uint8_t *slot = &incremental->solutions[(size_t)incremental->numSolutions++ * boardSize * boardSize];
+    for (int row = 0; row < boardSize; row++) {
+        for (int col = 0; col < boardSize; col++) {
+            *slot++ = solution[row][col];
+        }
+    }
+}
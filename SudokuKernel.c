@@ -0,0 +1,468 @@
+// SudokuKernel - the solver specialized for a single board size
+// this file is included once per board size by SudokuSolver.c, which defines the following before each include:
+//   KERNEL_BOX  - width of a box (3, 4 or 5)
+//   KERNEL_SIZE - number of rows, columns and digits in the board (KERNEL_BOX squared)
+//   KERNEL_MASK - fixed-width unsigned type with one bit per digit
+// every loop bound and box calculation below is a compile-time constant, so each size gets its own unrolled code
+
+//helpers to name each function after the board size (ie genSolution9, genSolution16)
+#define KERNEL_JOIN(name, size) name##size
+#define KERNEL_NAME(name, size) KERNEL_JOIN(name, size)
+#define KERNEL(name) KERNEL_NAME(name, KERNEL_SIZE)
+#define KERNEL_CELLS (KERNEL_SIZE * KERNEL_SIZE)
+#define KERNEL_FULL ((KERNEL_MASK)((1ULL << KERNEL_SIZE) - 1))
+
+// search state for one run of the kernel (kept on the stack so separate boards can be searched at the same time)
+typedef struct {
+    KERNEL_MASK rows[KERNEL_SIZE];  // digits currently used in each row
+    KERNEL_MASK cols[KERNEL_SIZE];  // digits currently used in each column
+    KERNEL_MASK boxes[KERNEL_SIZE]; // digits currently used in each box
+    int (*grid)[MAX_SIZE];          // board being searched
+    bool (*given)[MAX_SIZE];        // given cells of the board being searched
+    bool (*correct)[MAX_SIZE];      // correct cells of the board being searched (only used by markSolution)
+    int *solved;                    // solved state of the board being searched (only used by markSolution)
+    int *count;                     // number of solutions found so far (only used by getNumSolutions)
+    int max;                        // number of solutions to stop at (only used by getNumSolutions)
+    void (*visit)(int (*grid)[MAX_SIZE], void *data); // called with each solution counted (NULL = only count)
+    void *data;                                       // passed along to visit
+    int empty[KERNEL_CELLS];        // indexes of the cells left to fill (not used by markSolution)
+    int numEmpty;                   // number of entries in empty
+    long long nodes;                // cells tried by this search (added to kernelNodes when it ends)
+    long long limit;                // number of cells to give up after (copied from kernelNodeLimit)
+} KERNEL(Search);
+
+// returns the index of the box containing the cell
+static inline int KERNEL(boxOf)(int row, int col) {
+    return row / KERNEL_BOX * KERNEL_BOX + col / KERNEL_BOX;
+}
+
+// returns the bit representing a number (EMPTY has no bit)
+static inline KERNEL_MASK KERNEL(bitOf)(int num) {
+    return num == EMPTY ? 0 : (KERNEL_MASK)1 << (num - 1);
+}
+
+// returns the number represented by a single bit
+static inline int KERNEL(numOf)(KERNEL_MASK bit) {
+    return __builtin_ctz(bit) + 1;
+}
+
+// returns the numbers that don't repeat one already in the cell's row, column, or box
+static inline KERNEL_MASK KERNEL(freeNums)(KERNEL(Search) *s, int row, int col) {
+    return (KERNEL_MASK)(~(s->rows[row] | s->cols[col] | s->boxes[KERNEL(boxOf)(row, col)]) & KERNEL_FULL);
+}
+
+// marks a number as used in the cell's row, column, and box
+static inline void KERNEL(place)(KERNEL(Search) *s, int row, int col, KERNEL_MASK bit) {
+    s->rows[row] |= bit;
+    s->cols[col] |= bit;
+    s->boxes[KERNEL(boxOf)(row, col)] |= bit;
+}
+
+// marks a number as no longer used in the cell's row, column, and box
+static inline void KERNEL(lift)(KERNEL(Search) *s, int row, int col, KERNEL_MASK bit) {
+    s->rows[row] &= (KERNEL_MASK)~bit;
+    s->cols[col] &= (KERNEL_MASK)~bit;
+    s->boxes[KERNEL(boxOf)(row, col)] &= (KERNEL_MASK)~bit;
+}
+
+// fills the row, column, and box masks from the numbers currently in the grid
+static void KERNEL(load)(KERNEL(Search) *s) {
+    for (int i = 0; i < KERNEL_SIZE; i++) {
+        s->rows[i] = 0;
+        s->cols[i] = 0;
+        s->boxes[i] = 0;
+    }
+    for (int row = 0; row < KERNEL_SIZE; row++) {
+        for (int col = 0; col < KERNEL_SIZE; col++) {
+            KERNEL(place)(s, row, col, KERNEL(bitOf)(s->grid[row][col]));
+        }
+    }
+}
+
+// removes the cell's own number from the masks, except in units where another cell still holds it
+static void KERNEL(release)(KERNEL(Search) *s, int row, int col) {
+    int num = s->grid[row][col];
+    if (num == EMPTY) {
+        return;
+    }
+
+    //look for other copies of the number in the same row, column, and box
+    bool inRow = false, inCol = false, inBox = false;
+    for (int i = 0; i < KERNEL_SIZE; i++) {
+        inRow |= i != col && s->grid[row][i] == num;
+        inCol |= i != row && s->grid[i][col] == num;
+    }
+    int startRow = row / KERNEL_BOX * KERNEL_BOX;
+    int startCol = col / KERNEL_BOX * KERNEL_BOX;
+    for (int r = startRow; r < startRow + KERNEL_BOX; r++) {
+        for (int c = startCol; c < startCol + KERNEL_BOX; c++) {
+            inBox |= !(r == row && c == col) && s->grid[r][c] == num;
+        }
+    }
+
+    KERNEL_MASK bit = KERNEL(bitOf)(num);
+    if (!inRow) {
+        s->rows[row] &= (KERNEL_MASK)~bit;
+    }
+    if (!inCol) {
+        s->cols[col] &= (KERNEL_MASK)~bit;
+    }
+    if (!inBox) {
+        s->boxes[KERNEL(boxOf)(row, col)] &= (KERNEL_MASK)~bit;
+    }
+}
+
+// returns the free numbers above the one just tried, recomputed since deeper cells may have changed the grid
+static inline KERNEL_MASK KERNEL(nextNums)(KERNEL(Search) *s, int row, int col, KERNEL_MASK tried) {
+    return KERNEL(freeNums)(s, row, col) & (KERNEL_MASK) ~((tried << 1) - 1);
+}
+
+// marks incorrect cells from the given cell onwards, visiting cells in the same order as the original backtracker
+static bool KERNEL(markSolutionFrom)(KERNEL(Search) *s, int cell) {
+    s->nodes++;
+
+    //give up once the search has tried too many cells
+    if (s->nodes > s->limit) {
+        return false;
+    }
+
+    //skip given cells
+    while (cell < KERNEL_CELLS && s->given[cell / KERNEL_SIZE][cell % KERNEL_SIZE]) {
+        cell++;
+    }
+
+    //base case: reached the end of the board -> solved
+    if (cell == KERNEL_CELLS) {
+        return true;
+    }
+
+    int row = cell / KERNEL_SIZE;
+    int col = cell % KERNEL_SIZE;
+
+    //save initial number, which doesn't restrict the cell itself
+    int prev = s->grid[row][col];
+    KERNEL(release)(s, row, col);
+
+    //try each free number from lowest to highest
+    KERNEL_MASK free = KERNEL(freeNums)(s, row, col);
+    while (free) {
+        KERNEL_MASK bit = free & -free;
+        int num = KERNEL(numOf)(bit);
+
+        //assume temporarily this number is right
+        s->grid[row][col] = num;
+        KERNEL(place)(s, row, col, bit);
+
+        //recursively check the next cell
+        if (KERNEL(markSolutionFrom)(s, cell + 1)) {
+            //if found a solution, compare to the initial value
+            if (prev != num) {
+                //if not correct, update correct array and revert cell
+                s->correct[row][col] = false;
+                *s->solved = WRONG;
+            }
+            s->grid[row][col] = prev;
+            return true;
+        }
+
+        KERNEL(lift)(s, row, col, bit);
+        free = KERNEL(nextNums)(s, row, col, bit);
+    }
+
+    //if didn't find a solution, reset the cell
+    s->grid[row][col] = prev;
+    KERNEL(place)(s, row, col, KERNEL(bitOf)(prev));
+
+    //return to parent for backtracking
+    return false;
+}
+
+// moves the remaining empty cell with the fewest free numbers to the front of the remaining cells and returns its free numbers
+static KERNEL_MASK KERNEL(pickCell)(KERNEL(Search) *s, int depth) {
+    int best = depth;
+    KERNEL_MASK bestFree = 0;
+    int bestCount = KERNEL_SIZE + 1;
+    for (int i = depth; i < s->numEmpty; i++) {
+        int cell = s->empty[i];
+        KERNEL_MASK free = KERNEL(freeNums)(s, cell / KERNEL_SIZE, cell % KERNEL_SIZE);
+        int count = __builtin_popcount(free);
+        if (count < bestCount) {
+            best = i;
+            bestFree = free;
+            bestCount = count;
+
+            //can't do better than a forced or impossible cell
+            if (count <= 1) {
+                break;
+            }
+        }
+    }
+
+    int cell = s->empty[best];
+    s->empty[best] = s->empty[depth];
+    s->empty[depth] = cell;
+    return bestFree;
+}
+
+// counts the solutions for the remaining empty cells, always branching on the cell with the fewest free numbers
+static void KERNEL(countFrom)(KERNEL(Search) *s, int depth) {
+    s->nodes++;
+
+    //give up once the search has tried too many cells
+    if (s->nodes > s->limit) {
+        return;
+    }
+
+    //base case: every empty cell is filled -> solved
+    if (depth == s->numEmpty) {
+        *s->count += 1;
+        if (s->visit != NULL) {
+            s->visit(s->grid, s->data);
+        }
+        return;
+    }
+
+    KERNEL_MASK free = KERNEL(pickCell)(s, depth);
+    int row = s->empty[depth] / KERNEL_SIZE;
+    int col = s->empty[depth] % KERNEL_SIZE;
+    while (free) {
+        KERNEL_MASK bit = free & -free;
+        free ^= bit;
+
+        //assume temporarily this number is right
+        s->grid[row][col] = KERNEL(numOf)(bit);
+        KERNEL(place)(s, row, col, bit);
+
+        //recursively fill the remaining cells
+        KERNEL(countFrom)(s, depth + 1);
+
+        //reset the cell
+        KERNEL(lift)(s, row, col, bit);
+        s->grid[row][col] = EMPTY;
+
+        //if reached the maximum solution count, stop the recursion
+        if (*s->count >= s->max) {
+            return;
+        }
+    }
+}
+
+// fills the remaining empty cells with the first solution found, leaving them empty if there is none
+static bool KERNEL(findFrom)(KERNEL(Search) *s, int depth) {
+    s->nodes++;
+
+    //give up once the search has tried too many cells
+    if (s->nodes > s->limit) {
+        return false;
+    }
+
+    //base case: every empty cell is filled -> solved
+    if (depth == s->numEmpty) {
+        return true;
+    }
+
+    KERNEL_MASK free = KERNEL(pickCell)(s, depth);
+    int row = s->empty[depth] / KERNEL_SIZE;
+    int col = s->empty[depth] % KERNEL_SIZE;
+    while (free) {
+        KERNEL_MASK bit = free & -free;
+        free ^= bit;
+
+        //assume temporarily this number is right
+        s->grid[row][col] = KERNEL(numOf)(bit);
+        KERNEL(place)(s, row, col, bit);
+
+        //recursively fill the remaining cells, keeping the first solution
+        if (KERNEL(findFrom)(s, depth + 1)) {
+            return true;
+        }
+
+        //reset the cell
+        KERNEL(lift)(s, row, col, bit);
+        s->grid[row][col] = EMPTY;
+    }
+    return false;
+}
+
+// adds the numbers of a solution to the candidates of each empty cell, then empties the cells again
+static void KERNEL(takeWitness)(KERNEL(Search) *s, uint32_t (*candidates)[MAX_SIZE]) {
+    for (int i = 0; i < s->numEmpty; i++) {
+        int row = s->empty[i] / KERNEL_SIZE;
+        int col = s->empty[i] % KERNEL_SIZE;
+        KERNEL_MASK bit = KERNEL(bitOf)(s->grid[row][col]);
+        candidates[row][col] |= bit;
+        KERNEL(lift)(s, row, col, bit);
+        s->grid[row][col] = EMPTY;
+    }
+}
+
+// resolves the board with recursive backtracking, always branching on the cell with the fewest free numbers
+bool KERNEL(genSolution)(int row, int col, int (*grid)[MAX_SIZE], bool (*given)[MAX_SIZE]) {
+    KERNEL(Search) s;
+    s.grid = grid;
+    s.given = given;
+    s.nodes = 0;
+    s.limit = kernelNodeLimit;
+
+    //every cell that isn't given from the starting cell onwards is filled in again (left empty if there is no solution)
+    s.numEmpty = 0;
+    for (int cell = row * KERNEL_SIZE + col; cell < KERNEL_CELLS; cell++) {
+        if (!given[cell / KERNEL_SIZE][cell % KERNEL_SIZE]) {
+            grid[cell / KERNEL_SIZE][cell % KERNEL_SIZE] = EMPTY;
+            s.empty[s.numEmpty++] = cell;
+        }
+    }
+    KERNEL(load)(&s);
+
+    bool found = KERNEL(findFrom)(&s, 0);
+    kernelNodes += s.nodes;
+    return found;
+}
+
+// marks incorrect cells with recursive backtracking
+bool KERNEL(markSolution)(int row, int col, int (*grid)[MAX_SIZE], bool (*given)[MAX_SIZE], bool (*correct)[MAX_SIZE], int *solved) {
+    KERNEL(Search) s;
+    s.grid = grid;
+    s.given = given;
+    s.correct = correct;
+    s.solved = solved;
+    s.nodes = 0;
+    s.limit = kernelNodeLimit;
+    KERNEL(load)(&s);
+
+    bool found = KERNEL(markSolutionFrom)(&s, row * KERNEL_SIZE + col);
+    kernelNodes += s.nodes;
+    return found;
+}
+
+// calls visit with each solution of the board (up to the max), counting them like getNumSolutions
+void KERNEL(forEachSolution)(int row, int col, int (*grid)[MAX_SIZE], int *count, int max, void (*visit)(int (*grid)[MAX_SIZE], void *data), void *data) {
+    KERNEL(Search) s;
+    s.grid = grid;
+    s.count = count;
+    s.max = max;
+    s.visit = visit;
+    s.data = data;
+    s.nodes = 0;
+    s.limit = kernelNodeLimit;
+    KERNEL(load)(&s);
+
+    //only the empty cells from the starting cell onwards are filled in
+    s.numEmpty = 0;
+    for (int cell = row * KERNEL_SIZE + col; cell < KERNEL_CELLS; cell++) {
+        if (grid[cell / KERNEL_SIZE][cell % KERNEL_SIZE] == EMPTY) {
+            s.empty[s.numEmpty++] = cell;
+        }
+    }
+
+    KERNEL(countFrom)(&s, 0);
+    kernelNodes += s.nodes;
+}
+
+// calculates the number of solutions of the board (up to the max) with recursive backtracking
+void KERNEL(getNumSolutions)(int row, int col, int (*grid)[MAX_SIZE], int *count, int max) {
+    KERNEL(forEachSolution)(row, col, grid, count, max, NULL, NULL);
+}
+
+// finds the numbers each empty cell takes in at least one solution (returns false if there are no solutions)
+bool KERNEL(getCandidates)(int (*grid)[MAX_SIZE], uint32_t (*candidates)[MAX_SIZE]) {
+    //search a copy so the board is left untouched
+    int work[MAX_SIZE][MAX_SIZE];
+    KERNEL(Search) s;
+    s.grid = work;
+    s.numEmpty = 0;
+    s.nodes = 0;
+    s.limit = kernelNodeLimit;
+    for (int row = 0; row < KERNEL_SIZE; row++) {
+        for (int col = 0; col < KERNEL_SIZE; col++) {
+            work[row][col] = grid[row][col];
+            candidates[row][col] = 0;
+            if (grid[row][col] == EMPTY) {
+                s.empty[s.numEmpty++] = row * KERNEL_SIZE + col;
+            }
+        }
+    }
+    KERNEL(load)(&s);
+
+    //every number of the first solution is a candidate
+    if (!KERNEL(findFrom)(&s, 0)) {
+        kernelNodes += s.nodes;
+        return false;
+    }
+    KERNEL(takeWitness)(&s, candidates);
+
+    //the searches below reorder the empty list, so walk the cells from a copy
+    int cells[KERNEL_CELLS];
+    for (int i = 0; i < s.numEmpty; i++) {
+        cells[i] = s.empty[i];
+    }
+
+    //only search for the free numbers no solution has used yet, every solution found fills in other cells too
+    for (int i = 0; i < s.numEmpty; i++) {
+        //keep the cell at the front so the search only fills the other cells
+        int cell = cells[i];
+        for (int j = 0; j < s.numEmpty; j++) {
+            if (s.empty[j] == cell) {
+                s.empty[j] = s.empty[0];
+                s.empty[0] = cell;
+                break;
+            }
+        }
+
+        int row = cell / KERNEL_SIZE;
+        int col = cell % KERNEL_SIZE;
+        KERNEL_MASK untried = KERNEL(freeNums)(&s, row, col) & (KERNEL_MASK)~candidates[row][col];
+        while (untried) {
+            KERNEL_MASK bit = untried & -untried;
+            untried ^= bit;
+
+            s.grid[row][col] = KERNEL(numOf)(bit);
+            KERNEL(place)(&s, row, col, bit);
+            if (KERNEL(findFrom)(&s, 1)) {
+                KERNEL(takeWitness)(&s, candidates);
+
+                //the witness may have covered other untried numbers of this cell
+                untried &= (KERNEL_MASK)~candidates[row][col];
+            } else {
+                KERNEL(lift)(&s, row, col, bit);
+                s.grid[row][col] = EMPTY;
+            }
+        }
+    }
+    kernelNodes += s.nodes;
+    return true;
+}
+
+// does a shallow check of the cell (verifies it is unique within the row, column, and box)
+bool KERNEL(isValidShallow)(int row, int col, int num, int (*grid)[MAX_SIZE]) {
+    //check for duplicate values in the same row and column
+    for (int i = 0; i < KERNEL_SIZE; i++) {
+        if (col != i && grid[row][i] == num) {
+            return false;
+        }
+        if (row != i && grid[i][col] == num) {
+            return false;
+        }
+    }
+
+    //calculate the first row and column in the cell's box
+    int startRow = row / KERNEL_BOX * KERNEL_BOX;
+    int startCol = col / KERNEL_BOX * KERNEL_BOX;
+
+    //check for duplicates in the same box
+    for (int r = 0; r < KERNEL_BOX; r++) {
+        for (int c = 0; c < KERNEL_BOX; c++) {
+            if (!(startRow + r == row && startCol + c == col) && grid[startRow + r][startCol + c] == num) {
+                return false;
+            }
+        }
+    }
+
+    //cell passed shallow tests
+    return true;
+}
+
+//the including file redefines these for the next board size
+#undef KERNEL_BOX
+#undef KERNEL_SIZE
+#undef KERNEL_MASK
@@ -1,47 +1,181 @@
 #include "SudokuDefinitions.h"
 #include "SudokuPrinter.c"
+#include "SudokuFormat.c"
+#include "SudokuServer.c"
+#include "SudokuReplay.c"
+#include "SudokuReducer.c"
+#include "SudokuEnumerator.c"
+#include "SudokuFuzz.c"
+#include "SudokuPattern.c"
+#include "SudokuGrader.c"
 #include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
 #include <unistd.h>
 
-// grid - 9x9 int array to hold contents of each cell in the sudoku board
-int grid[9][9];
-// given - 9x9 boolean array to hold the type of each cell (true = a given number, false = a penciled number)
-bool given[9][9];
-// correct - 9x9 boolean array to hold the validity of each cell (true = correct)
-bool correct[9][9];
+// grid - 2D int array to hold contents of each cell in the sudoku board (only the first boardSize rows and columns are used)
+int grid[MAX_SIZE][MAX_SIZE];
+// given - 2D boolean array to hold the type of each cell (true = a given number, false = a penciled number)
+bool given[MAX_SIZE][MAX_SIZE];
+// correct - 2D boolean array to hold the validity of each cell (true = correct)
+bool correct[MAX_SIZE][MAX_SIZE];
+// boardSize - int value holding the number of rows, columns, and digits in the board (9, 16, or 25)
+int boardSize = 9;
+// boxSize - int value holding the number of rows and columns in each box (3, 4, or 5)
+int boxSize = 3;
 // unique - boolean value to keep track of state of board (true = there is a unique solution, false = there are multiple solutions)
 bool unique;
 // solved - int value to keep track of state of the board (WRONG,CHECKED,CORRECT)
 int solved;
-// numGivens - int value to keep track of the number of givens inputted so far (at least 17 are needed for a unique solution)
+// numGivens - int value to keep track of the number of givens inputted so far (at least 17 are needed for a unique 9x9 solution)
 int numGivens;
 // inHelp - boolean value used to toggle the help page
 bool inHelp = false;
-// undoQueue - 2D int array to hold the previous versions of cells for undo functionality
-int undoQueue[UNDO_SIZE][3];
+// undoQueue - snapshots of the board before each change for undo functionality, oldest first (consecutive snapshots share their unchanged rows)
+Snapshot *undoQueue[UNDO_SIZE];
 // undoPtr - index of most recent undo entry
 int undoPtr = 0;
 // pencilMode - if true, all inputs are treated are no longer treated as givens
 bool pencilMode = false;
+// candidates - 2D array holding the numbers each empty cell takes in at least one solution (one bit per number)
+uint32_t candidates[MAX_SIZE][MAX_SIZE];
+// showCandidates - if true, the grid shows how many numbers each empty cell can still take
+bool showCandidates = false;
+// inputStream - where commands and cell inputs are read from (stdin unless replaying a script)
+FILE *inputStream;
+// rendering - if false, the panel isn't printed (used to replay scripts without a terminal)
+bool rendering = true;
+// replayPath - command script to replay without rendering (NULL = interactive mode)
+char *replayPath = NULL;
+// reducePath - file of boards (one per line, '-' = stdin) to strip of redundant givens (NULL = interactive mode)
+char *reducePath = NULL;
+// enumerateBoard - board (as a single-line string) to write every solution of to enumeratePath (NULL = interactive mode)
+char *enumerateBoard = NULL;
+// enumeratePath - file the solutions of enumerateBoard are written to
+char *enumeratePath = NULL;
+// enumerateLimit - maximum number of solutions to keep in enumeratePath, or of puzzles to generate for patternMask (0 = no limit)
+long long enumerateLimit = 0;
+// resumeEnumeration - if true, the enumeration picks up the subtrees enumeratePath doesn't have yet
+bool resumeEnumeration = false;
+// decodePath - solution file to print as board strings (NULL = interactive mode)
+char *decodePath = NULL;
+// fuzzBoards - number of random boards to check the kernels against the legacy solver on (0 = interactive mode)
+int fuzzBoards = 0;
+// fuzzSeed - seed of the random boards (the same seed gives the same boards)
+unsigned int fuzzSeed = 1;
+// baselinePath - stored fuzz run to compare the kernel's nodes and times to (created if missing, NULL = no comparison)
+char *baselinePath = NULL;
+// profilePath - file the Chrome trace of the profiled spans is written to on exit (NULL = no profiling)
+char *profilePath = NULL;
+// serverAddress - Unix socket path or localhost port to serve solver requests on (NULL = interactive mode)
+char *serverAddress = NULL;
+// numWorkers - number of worker threads in the server and batch modes (0 = one per core)
+int numWorkers = 0;
+// patternMask - board string whose filled cells are where the generated puzzles' givens go (NULL = interactive mode)
+char *patternMask = NULL;
+// patternSeconds - how long to generate puzzles for patternMask
+int patternSeconds = PATTERN_SECONDS;
+// variantPath - file with the diagonal, jigsaw, and killer rules of the board (NULL = standard sudoku)
+char *variantPath = NULL;
+// cachePath - file the solution counts are shared through between sessions and processes (NULL = no cache)
+char *cachePath = NULL;
+// gradePath - file of boards (one per line, '-' = stdin) to grade by the hardest solving technique they need (NULL = interactive mode)
+char *gradePath = NULL;
 
 // SudokuMaker - contains the following functions to handle input and manipulate the sudoku board
+bool handleArguments(int argc, char **argv);              // handles the command line options
 void handleInput();                                       // handles all of the user input
+void handleWord(char *input, bool *stop);                 // handles a single word of input
 void handleCommand(char command, bool *stop);             // handles single letter commands
 void handleCellInput(char *cell);                         // handles cell location and number inputs
 void reset();                                             // clears the board and resets all the states
 bool solveGrid();                                         // solves board if the board is unique
 bool checkGrid();                                         // checks the penciled cells in a board
-void genGrid();                                           // generates a valid board
+bool genGrid();                                           // generates a valid board (returns false if the rules allow none)
+int genBoard(int (*grid)[MAX_SIZE], bool (*given)[MAX_SIZE]);        // generates a valid board into the arrays and returns the number of givens (-1 if none)
+int genPatternBoard(int (*grid)[MAX_SIZE], bool (*given)[MAX_SIZE]); // generates a valid board for sizes without a hardcoded board
+int genVariantBoard(int (*grid)[MAX_SIZE], bool (*given)[MAX_SIZE]); // generates a valid board that follows the variant rules (-1 if none)
 bool updateGrid(int row, int col, int num, bool isGiven); // updates a cell in the board
-void addToUndoQueue(int row, int col, int num);           // saves the previous version of the modified cell in the undo queue
+bool addRandomGiven();                                    // adds a random given that keeps the board solvable
+int reduceGrid(bool *minimal);                            // removes the givens a unique board doesn't need (returns how many, -1 if not unique)
+void addToUndoQueue();                                    // saves a snapshot of the board before a change in the undo queue
+void clearUndoQueue();                                    // drops every snapshot in the undo queue
 bool undoLastCellAssignment();                            // undoes the last cell assignment
 void exitPencilMode();                                    // sets mode back to default
 void clearPencilMarks();                                  //clears pencil marks
 
-int main(void) {
+int main(int argc, char **argv) {
+    if (!handleArguments(argc, argv)) {
+        return 1;
+    }
+
+    inputStream = stdin;
+    srand(time(NULL));
+
+    //the variant rules replace the specialized kernel for every mode
+    if (variantPath != NULL && !loadVariant(variantPath)) {
+        return 1;
+    }
+
+    //every mode that searches asks the cache first (opened after the variant so the rules are part of the check)
+    if (cachePath != NULL && !openCache(cachePath, variant != NULL ? hashVariant() : 0)) {
+        return 1;
+    }
+
+    //record the solver and render spans until the program exits
+    if (profilePath != NULL) {
+        startProfiling(profilePath);
+        atexit(finishProfiling);
+    }
+
+    //server mode replaces the interactive screens
+    if (serverAddress != NULL) {
+        return runServer(serverAddress, numWorkers > 0 ? numWorkers : (int)sysconf(_SC_NPROCESSORS_ONLN));
+    }
+
+    //replay mode runs a command script and prints a summary instead
+    if (replayPath != NULL) {
+        return runReplay(replayPath);
+    }
+
+    //batch mode strips the redundant givens of every board in a file
+    if (reducePath != NULL) {
+        return runReduceBatch(reducePath, numWorkers > 0 ? numWorkers : (int)sysconf(_SC_NPROCESSORS_ONLN));
+    }
+
+    //enumeration mode writes every solution of a board to a file
+    if (enumerateBoard != NULL) {
+        return runEnumeration(enumerateBoard, enumeratePath, enumerateLimit, resumeEnumeration, numWorkers > 0 ? numWorkers : (int)sysconf(_SC_NPROCESSORS_ONLN));
+    }
+    if (decodePath != NULL) {
+        return runDecode(decodePath);
+    }
+
+    //pattern mode generates unique puzzles with givens exactly on a mask
+    if (patternMask != NULL) {
+        return runPattern(patternMask, enumerateLimit, patternSeconds, numWorkers > 0 ? numWorkers : (int)sysconf(_SC_NPROCESSORS_ONLN));
+    }
+
+    //grading mode labels every board in a file with the hardest technique it needs and a score
+    if (gradePath != NULL) {
+        if (variant != NULL) {
+            fprintf(stderr, "Sorry, the grader only knows the techniques for the standard rules, so --grade can't be used with --variant.\n");
+            return 1;
+        }
+        return runGrade(gradePath, numWorkers > 0 ? numWorkers : (int)sysconf(_SC_NPROCESSORS_ONLN));
+    }
+
+    //fuzz mode checks the kernels against the legacy solver
+    if (fuzzBoards > 0) {
+        if (variant != NULL) {
+            fprintf(stderr, "Sorry, the legacy solver only knows the standard rules, so --fuzz can't be used with --variant.\n");
+            return 1;
+        }
+        return runFuzz(fuzzBoards, fuzzSeed, baselinePath);
+    }
+
     printWelcomeMessage();
 
     //wait for 'enter' key to continue
@@ -56,6 +190,69 @@ int main(void) {
     return 0;
 }
 
+// handles the command line options
+bool handleArguments(int argc, char **argv) {
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--size") == 0 && i + 1 < argc) {
+            //pick the solver specialized for the requested board size
+            if (!selectKernel(atoi(argv[++i]))) {
+                fprintf(stderr, "Sorry, the board size must be 9, 16, or 25.\n");
+                return false;
+            }
+        } else if (strcmp(argv[i], "--variant") == 0 && i + 1 < argc) {
+            //play by diagonal, jigsaw, or killer rules (read after every option, so --size can come either side)
+            variantPath = argv[++i];
+        } else if (strcmp(argv[i], "--cache") == 0 && i + 1 < argc) {
+            //reuse the solution counts of earlier sessions and other processes (created if missing)
+            cachePath = argv[++i];
+        } else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+            //replay a command script instead of starting the interactive mode
+            replayPath = argv[++i];
+        } else if (strcmp(argv[i], "--reduce") == 0 && i + 1 < argc) {
+            //strip the redundant givens of every board in a file instead of starting the interactive mode
+            reducePath = argv[++i];
+        } else if (strcmp(argv[i], "--enumerate") == 0 && i + 2 < argc) {
+            //write every solution of a board to a file instead of starting the interactive mode
+            enumerateBoard = argv[++i];
+            enumeratePath = argv[++i];
+        } else if (strcmp(argv[i], "--limit") == 0 && i + 1 < argc) {
+            enumerateLimit = atoll(argv[++i]);
+        } else if (strcmp(argv[i], "--resume") == 0) {
+            resumeEnumeration = true;
+        } else if (strcmp(argv[i], "--decode") == 0 && i + 1 < argc) {
+            //print the solutions in a file written by --enumerate
+            decodePath = argv[++i];
+        } else if (strcmp(argv[i], "--pattern") == 0 && i + 1 < argc) {
+            //generate unique puzzles with givens on the mask's filled cells instead of starting the interactive mode
+            patternMask = argv[++i];
+        } else if (strcmp(argv[i], "--seconds") == 0 && i + 1 < argc) {
+            patternSeconds = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--grade") == 0 && i + 1 < argc) {
+            //grade every board in a file by the human techniques it needs instead of starting the interactive mode
+            gradePath = argv[++i];
+        } else if (strcmp(argv[i], "--fuzz") == 0 && i + 1 < argc) {
+            //check the kernels against the legacy solver on random boards instead of starting the interactive mode
+            fuzzBoards = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            fuzzSeed = strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--baseline") == 0 && i + 1 < argc) {
+            baselinePath = argv[++i];
+        } else if (strcmp(argv[i], "--profile") == 0 && i + 1 < argc) {
+            //time the solver and render calls with hardware counters and write a Chrome trace on exit
+            profilePath = argv[++i];
+        } else if (strcmp(argv[i], "--server") == 0 && i + 1 < argc) {
+            //serve solver requests instead of starting the interactive mode
+            serverAddress = argv[++i];
+        } else if (strcmp(argv[i], "--workers") == 0 && i + 1 < argc) {
+            numWorkers = atoi(argv[++i]);
+        } else {
+            fprintf(stderr, "Usage: %s [--size 9|16|25] [--variant rules] [--cache file] [--replay script] [--reduce boards|-] [--enumerate board output [--limit count] [--resume]] [--decode solutions] [--pattern mask [--limit count] [--seconds n]] [--grade boards|-] [--fuzz boards [--seed n] [--baseline file]] [--profile trace.json] [--server socket-path|port] [--workers count]\n", argv[0]);
+            return false;
+        }
+    }
+    return true;
+}
+
 // handles all of the user input
 void handleInput() {
     bool stop = false;
@@ -63,25 +260,35 @@ void handleInput() {
     //loop until user enters exit command 'e'
     while (!stop) {
         //allocate space for the input
-        //the largest word should be two characters (for the cell location)
-        char *input = malloc(2);
-
-        scanf("%s", input);
-
-        //determine type of input by its length
-        if (strlen(input) == 1) {
-            //one letter = command
-            //pass stop in case exit command is called
-            handleCommand(input[0], &stop);
-        } else if (strlen(input) == 2) {
-            //two letter = cell location
-            handleCellInput(input);
-        } else {
-            printCommandErrorMessage();
-        }
+        //the largest word should be three characters (for the cell location on 16x16 and 25x25 boards)
+        char *input = malloc(32);
+
+        fscanf(inputStream, "%31s", input);
+
+        //pass stop in case exit command is called
+        handleWord(input, &stop);
+
+        free(input);
     }
 }
 
+// handles a single word of input
+void handleWord(char *input, bool *stop) {
+    int span = profileBegin("command");
+
+    //determine type of input by its length
+    if (strlen(input) == 1) {
+        //one letter = command
+        handleCommand(input[0], stop);
+    } else if (strlen(input) <= 3) {
+        //two or three letters = cell location
+        handleCellInput(input);
+    } else {
+        printCommandErrorMessage();
+    }
+    profileEnd(span);
+}
+
 // handles single letter commands
 void handleCommand(char command, bool *stop) {
     if (command == 'e') {
@@ -100,9 +307,14 @@ void handleCommand(char command, bool *stop) {
         reset();
 
         //generate valid board
-        genGrid();
+        bool generated = genGrid();
 
         printPanel();
+
+        //if the rules allow no board, print error message
+        if (!generated) {
+            printUnableToGenerateMessage();
+        }
     } else if (command == 'h') {
         //check inHelp toggle
         if (inHelp) {
@@ -149,7 +361,7 @@ void handleCommand(char command, bool *stop) {
             printPanel();
 
             //reset undo queue
-            undoPtr = 0;
+            clearUndoQueue();
         } else {
             //if not unique, print error message
             printUnableToEnterPencilModeMessage();
@@ -164,6 +376,47 @@ void handleCommand(char command, bool *stop) {
         if (!checked) {
             printUnableToCheckMessage();
         }
+    } else if (command == 'a') {
+        //attempt to add a random given
+        bool added = addRandomGiven();
+
+        printPanel();
+
+        //if couldn't add, print error message
+        if (!added) {
+            printUnableToAddMessage();
+        }
+    } else if (command == 'd') {
+        //attempt to drop the givens the board doesn't need
+        bool minimal;
+        int removed = reduceGrid(&minimal);
+
+        printPanel();
+
+        //if not unique, print error message
+        if (removed < 0) {
+            printUnableToReduceMessage();
+        } else {
+            printReducedMessage(removed, minimal);
+        }
+    } else if (command == 'n') {
+        //attempt to suggest the givens that cut down the number of solutions the most
+        Suggestion suggestions[NUM_SUGGESTIONS];
+        int numSuggestions = pencilMode ? 0 : suggestGivens(suggestions);
+
+        printPanel();
+
+        //if no suggestions, print error message
+        if (numSuggestions == 0) {
+            printUnableToSuggestMessage();
+        } else {
+            printSuggestions(suggestions, numSuggestions);
+        }
+    } else if (command == 'o') {
+        //toggle the candidate overlay
+        showCandidates = !showCandidates;
+
+        printPanel();
     } else if (command != '\n') {
         printCommandErrorMessage();
     }
@@ -173,6 +426,7 @@ void handleCommand(char command, bool *stop) {
 void handleCellInput(char *cell) {
     char rowChar;
     int col, num;
+    int span = profileBegin("parse");
 
     //extract row character and column number from input
     sscanf(cell, "%c%d", &rowChar, &col);
@@ -182,16 +436,18 @@ void handleCellInput(char *cell) {
     col--;
 
     //make sure the cell location is within range
-    if (row < 0 || row > 8 || col < 0 || col > 8) {
+    if (row < 0 || row >= boardSize || col < 0 || col >= boardSize) {
+        profileEnd(span);
         printCommandErrorMessage();
         return;
     }
 
     //get the number (to put in the cell)
-    scanf("%d", &num);
+    fscanf(inputStream, "%d", &num);
+    profileEnd(span);
 
     //make sure the number is within range
-    if (num < EMPTY || num > 9) {
+    if (num < EMPTY || num > boardSize) {
         printCommandErrorMessage();
     } else if (updateGrid(row, col, num, true)) {
         //if cell was updated, print the updated grid
@@ -207,8 +463,8 @@ void reset() {
 
     //reset grid, given, and correct arrays
     numGivens = 0;
-    for (int row = 0; row < 9; row++) {
-        for (int col = 0; col < 9; col++) {
+    for (int row = 0; row < boardSize; row++) {
+        for (int col = 0; col < boardSize; col++) {
             grid[row][col] = EMPTY;
             given[row][col] = false;
             correct[row][col] = true;
@@ -216,7 +472,7 @@ void reset() {
     }
 
     //reset undo queue
-    undoPtr = 0;
+    clearUndoQueue();
 }
 
 // solves board if the board is unique
@@ -244,8 +500,29 @@ bool checkGrid() {
     return false;
 }
 
-// generates a valid board
-void genGrid() {
+// generates a valid board (returns false if the rules allow none)
+bool genGrid() {
+    int num = genBoard(grid, given);
+    if (num < 0) {
+        return false;
+    }
+    numGivens = num;
+    unique = true;
+    return true;
+}
+
+// generates a valid board into the arrays and returns the number of givens (-1 if none)
+int genBoard(int (*grid)[MAX_SIZE], bool (*given)[MAX_SIZE]) {
+    //the hardcoded and patterned boards only follow the standard rules
+    if (variant != NULL) {
+        return genVariantBoard(grid, given);
+    }
+
+    //only the 9x9 board is hardcoded
+    if (boardSize != 9) {
+        return genPatternBoard(grid, given);
+    }
+
     //TBD - hardcoded for now
     grid[0][0] = 8;
     grid[0][6] = 7;
@@ -275,7 +552,6 @@ void genGrid() {
     grid[8][5] = 3;
     grid[8][6] = 6;
     grid[8][8] = 4;
-    numGivens = 28;
     given[0][0] = true;
     given[0][6] = true;
     given[0][7] = true;
@@ -304,7 +580,64 @@ void genGrid() {
     given[8][5] = true;
     given[8][6] = true;
     given[8][8] = true;
-    unique = true;
+    return 28;
+}
+
+// generates a valid board for sizes without a hardcoded board
+int genPatternBoard(int (*grid)[MAX_SIZE], bool (*given)[MAX_SIZE]) {
+    //fill the board with a patterned solution where each row shifts the previous one
+    for (int row = 0; row < boardSize; row++) {
+        for (int col = 0; col < boardSize; col++) {
+            grid[row][col] = (row % boxSize * boxSize + row / boxSize + col) % boardSize + 1;
+            given[row][col] = true;
+        }
+    }
+
+    //empty the diagonal, each of these cells is the only empty cell in its row so the solution stays unique
+    for (int i = 0; i < boardSize; i++) {
+        grid[i][i] = EMPTY;
+        given[i][i] = false;
+    }
+    return boardSize * boardSize - boardSize;
+}
+
+// generates a valid board that follows the variant rules (-1 if none)
+int genVariantBoard(int (*grid)[MAX_SIZE], bool (*given)[MAX_SIZE]) {
+    //seed a few random givens, keeping the board solvable, so each board comes out different
+    int clues[MAX_SIZE][MAX_SIZE] = {{0}};
+    for (int i = 0; i < boardSize; i++) {
+        int row = rand() % boardSize, col = rand() % boardSize, num = rand() % boardSize + 1;
+        if (clues[row][col] != EMPTY || !kernel->isValidShallow(row, col, num, clues)) {
+            continue;
+        }
+        clues[row][col] = num;
+        int count = 0;
+        kernel->getNumSolutions(0, 0, clues, &count, 1);
+        if (count == 0) {
+            clues[row][col] = EMPTY;
+        }
+    }
+
+    //fill in a whole solution (copied out, the search empties its cells again), then strip the givens it doesn't need
+    int count = 0;
+    int solution[MAX_SIZE][MAX_SIZE];
+    kernel->forEachSolution(0, 0, clues, &count, 1, saveSolution, solution);
+    if (count == 0) {
+        return -1;
+    }
+    memcpy(clues, solution, sizeof(clues));
+    bool minimal;
+    reduceBoard(clues, (int)sysconf(_SC_NPROCESSORS_ONLN), REDUCE_SECONDS, &minimal);
+
+    int numGivens = 0;
+    for (int row = 0; row < boardSize; row++) {
+        for (int col = 0; col < boardSize; col++) {
+            grid[row][col] = clues[row][col];
+            given[row][col] = clues[row][col] != EMPTY;
+            numGivens += given[row][col];
+        }
+    }
+    return numGivens;
 }
 
 // updates a cell in the board
@@ -317,7 +650,7 @@ bool updateGrid(int row, int col, int num, bool isGiven) {
             return false;
         } else {
             //add entry to undo queue
-            addToUndoQueue(row, col, grid[row][col]);
+            addToUndoQueue();
 
             //reset correct if the number changed
             if (grid[row][col] != num) {
@@ -341,7 +674,7 @@ bool updateGrid(int row, int col, int num, bool isGiven) {
         } //if filled a non empty cell, number of givens doesn't change
 
         //add entry to undo queue
-        addToUndoQueue(row, col, grid[row][col]);
+        addToUndoQueue();
 
         //update grid and given
         grid[row][col] = num;
@@ -356,23 +689,82 @@ bool updateGrid(int row, int col, int num, bool isGiven) {
     }
 }
 
-// saves the previous version of the modified cell in the undo queue
-void addToUndoQueue(int row, int col, int num) {
-    if (undoPtr == UNDO_SIZE) {
-        //if undo queue is full, make shift each entry down one to make space
-        for (int i = 0; i < UNDO_SIZE - 1; i++) {
-            for (int j = 0; j < 3; j++) {
-                undoQueue[i][j] = undoQueue[i + 1][j];
+// adds a random given that keeps the board solvable
+bool addRandomGiven() {
+    //givens can only be added in make mode
+    if (pencilMode || !getCandidates(candidates)) {
+        return false;
+    }
+
+    //pick evenly among every number that some solution puts in an empty cell
+    int total = 0;
+    for (int row = 0; row < boardSize; row++) {
+        for (int col = 0; col < boardSize; col++) {
+            total += __builtin_popcount(candidates[row][col]);
+        }
+    }
+    if (total == 0) {
+        return false;
+    }
+
+    int pick = rand() % total;
+    for (int row = 0; row < boardSize; row++) {
+        for (int col = 0; col < boardSize; col++) {
+            for (int num = 1; num <= boardSize; num++) {
+                if ((candidates[row][col] & (1u << (num - 1))) && pick-- == 0) {
+                    return updateGrid(row, col, num, true);
+                }
             }
         }
+    }
+    return false;
+}
+
+// removes the givens a unique board doesn't need (returns how many, -1 if not unique)
+int reduceGrid(bool *minimal) {
+    if (!unique || pencilMode) {
+        return -1;
+    }
+
+    int removed = reduceBoard(grid, (int)sysconf(_SC_NPROCESSORS_ONLN), REDUCE_SECONDS, minimal);
+    if (removed > 0) {
+        //the removed cells are no longer givens
+        for (int row = 0; row < boardSize; row++) {
+            for (int col = 0; col < boardSize; col++) {
+                if (grid[row][col] == EMPTY) {
+                    given[row][col] = false;
+                }
+            }
+        }
+        numGivens -= removed;
+
+        //reset undo queue
+        clearUndoQueue();
+    }
+    return removed;
+}
+
+// saves a snapshot of the board before a change in the undo queue
+void addToUndoQueue() {
+    if (undoPtr == UNDO_SIZE) {
+        //if undo queue is full, drop the oldest snapshot and shift each entry down one to make space
+        releaseSnapshot(undoQueue[0]);
+        memmove(undoQueue, undoQueue + 1, sizeof(Snapshot *) * (UNDO_SIZE - 1));
         undoPtr -= 1;
     }
-    undoQueue[undoPtr][0] = row;
-    undoQueue[undoPtr][1] = col;
-    undoQueue[undoPtr][2] = num;
+
+    //only the rows changed since the last snapshot are copied
+    undoQueue[undoPtr] = takeSnapshot(grid, given, correct, undoPtr > 0 ? undoQueue[undoPtr - 1] : NULL);
     undoPtr += 1;
 }
 
+// drops every snapshot in the undo queue
+void clearUndoQueue() {
+    while (undoPtr > 0) {
+        releaseSnapshot(undoQueue[--undoPtr]);
+    }
+}
+
 //undoes the last cell assignment
 bool undoLastCellAssignment() {
     if (undoPtr == 0) {
@@ -383,13 +775,16 @@ bool undoLastCellAssignment() {
     //move pointer to most recent entry
     undoPtr -= 1;
 
-    //get last undo entry
-    int row = undoQueue[undoPtr][0];
-    int col = undoQueue[undoPtr][1];
-    int num = undoQueue[undoPtr][2];
+    //reset the whole board to the snapshot, including which cells are givens
+    restoreSnapshot(undoQueue[undoPtr], grid, given, correct);
+    releaseSnapshot(undoQueue[undoPtr]);
 
-    //reset cell to previous value
-    grid[row][col] = num;
+    numGivens = 0;
+    for (int row = 0; row < boardSize; row++) {
+        for (int col = 0; col < boardSize; col++) {
+            numGivens += given[row][col] && grid[row][col] != EMPTY;
+        }
+    }
 
     //assume no longer unique with modification
     unique = false;
@@ -407,8 +802,8 @@ void exitPencilMode() {
 
 // clears pencil marks
 void clearPencilMarks() {
-    for (int row = 0; row < 9; row++) {
-        for (int col = 0; col < 9; col++) {
+    for (int row = 0; row < boardSize; row++) {
+        for (int col = 0; col < boardSize; col++) {
             if (!given[row][col]) {
                 grid[row][col] = EMPTY;
                 correct[row][col] = true;
@@ -0,0 +1,242 @@
+#include "SudokuDefinitions.h"
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// boardSize - int value holding the number of rows, columns, and digits in the board (9, 16, or 25)
+extern int boardSize;
+
+// PatternSearch - state shared by the threads looking for unique puzzles with the given cells of a mask
+typedef struct {
+    int cells[MAX_SIZE * MAX_SIZE];     // cells of the mask, in the order they are filled
+    int numCells;                       // number of entries in cells
+    uint64_t *explored;                 // hashes of the partial fills no thread needs to search again (0 = empty slot)
+    long long limit;                    // number of puzzles to stop at (0 = until the time is up)
+    struct timespec deadline;           // time to stop searching
+    bool stop;                          // set once the limit or the deadline is reached
+    int found;                          // number of unique puzzles printed so far
+    long long leaves;                   // full fills checked for a unique solution
+    long long rejected;                 // partial fills rejected for having no solution
+    long long skipped;                  // partial fills skipped because another thread already searched them
+    pthread_mutex_t lock;               // guards found and the output
+} PatternSearch;
+
+// PatternWorker - one thread's randomized depth-first search over the mask's numbers
+typedef struct {
+    pthread_t thread;
+    PatternSearch *search;              // state shared with the other threads
+    unsigned int seed;                  // random state of the thread (picks the order numbers are tried in)
+    int clues[MAX_SIZE][MAX_SIZE];      // board filled so far
+    uint64_t prefix[MAX_SIZE * MAX_SIZE + 1]; // hash of the fill at each depth
+    int leavesLeft;                     // full fills to check before restarting with new random choices
+} PatternWorker;
+
+// SudokuPattern - contains the following functions to generate unique puzzles whose givens sit exactly on a mask
+int runPattern(char *mask, long long limit, int seconds, int numThreads); // generates puzzles for the mask in parallel and prints the yield
+void *generatePatterns(void *arg);                                          // thread loop that restarts the search with new random choices until stopped
+bool fillPattern(PatternWorker *worker, int depth);                         // fills the mask from a depth onwards (returns false if cut short by a restart or stop)
+bool checkPatternStop(PatternSearch *search);                               // checks if the limit or deadline was reached
+bool isExplored(PatternSearch *search, uint64_t hash);                      // checks if a partial fill is in the shared table
+bool markExplored(PatternSearch *search, uint64_t hash);                    // adds a partial fill to the shared table (returns false if it was already there or didn't fit)
+uint64_t hashPattern(uint64_t prefix, int cell, int num);                   // extends the hash of a partial fill with one more number
+
+// generates puzzles for the mask in parallel and prints the yield
+int runPattern(char *mask, long long limit, int seconds, int numThreads) {
+    if ((int)strlen(mask) != boardSize * boardSize) {
+        fprintf(stderr, "The mask must have %d characters, one per cell ('.' or '0' = empty).\n", boardSize * boardSize);
+        return 1;
+    }
+
+    PatternSearch *search = calloc(1, sizeof(PatternSearch));
+    for (int cell = 0; cell < boardSize * boardSize; cell++) {
+        if (mask[cell] != '.' && mask[cell] != '0') {
+            search->cells[search->numCells++] = cell;
+        }
+    }
+    if (search->numCells < kernel->minGivens) {
+        fprintf(stderr, "No %dx%d board with %d givens has a unique solution (at least %d are needed).\n", boardSize, boardSize, search->numCells, kernel->minGivens);
+        free(search);
+        return 1;
+    }
+
+    search->explored = calloc(PATTERN_TABLE_SIZE, sizeof(uint64_t));
+    search->limit = limit;
+    pthread_mutex_init(&search->lock, NULL);
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    search->deadline = start;
+    search->deadline.tv_sec += seconds;
+
+    PatternWorker *workers = calloc(numThreads, sizeof(PatternWorker));
+    for (int i = 0; i < numThreads; i++) {
+        workers[i].search = search;
+        workers[i].seed = (unsigned int)time(NULL) * 2654435761u + i;
+        pthread_create(&workers[i].thread, NULL, generatePatterns, &workers[i]);
+    }
+    for (int i = 0; i < numThreads; i++) {
+        pthread_join(workers[i].thread, NULL);
+    }
+
+    //yield per hour is what decides whether a pattern is worth running overnight
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double elapsed = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+    fprintf(stderr, "Generated %d puzzles with %d givens in %.1f seconds on %d threads (%.1f per hour).\n", search->found, search->numCells, elapsed, numThreads, search->found * 3600.0 / elapsed);
+    fprintf(stderr, "Checked %lld full fills for uniqueness, rejected %lld partial fills without a solution, skipped %lld searched by another thread.\n", search->leaves, search->rejected, search->skipped);
+
+    free(workers);
+    free(search->explored);
+    pthread_mutex_destroy(&search->lock);
+    free(search);
+    return 0;
+}
+
+// thread loop that restarts the search with new random choices until stopped
+void *generatePatterns(void *arg) {
+    PatternWorker *worker = arg;
+    while (!checkPatternStop(worker->search)) {
+        //a search stuck among fills with several solutions rarely recovers, so restart it every so often
+        memset(worker->clues, 0, sizeof(worker->clues));
+        worker->prefix[0] = 0x9e3779b97f4a7c15ULL;
+        worker->leavesLeft = PATTERN_RESTART;
+        fillPattern(worker, 0);
+    }
+    return NULL;
+}
+
+// fills the mask from a depth onwards (returns false if cut short by a restart or stop)
+bool fillPattern(PatternWorker *worker, int depth) {
+    PatternSearch *search = worker->search;
+
+    //base case: every cell of the mask is filled -> keep the puzzle if it has exactly one solution
+    if (depth == search->numCells) {
+        __atomic_fetch_add(&search->leaves, 1, __ATOMIC_RELAXED);
+        worker->leavesLeft--;
+
+        //claim the full fill in the shared table before printing it, so two threads that reach the same puzzle can't both print it
+        int count = 0;
+        kernel->getNumSolutions(0, 0, worker->clues, &count, 2);
+        if (count == 1 && markExplored(search, worker->prefix[depth])) {
+            char str[MAX_SIZE * MAX_SIZE + 1];
+            formatBoard(worker->clues, str);
+            pthread_mutex_lock(&search->lock);
+            if (search->limit == 0 || search->found < search->limit) {
+                printf("%s\n", str);
+                fflush(stdout);
+                search->found++;
+            }
+            pthread_mutex_unlock(&search->lock);
+        }
+        return true;
+    }
+
+    int cell = search->cells[depth];
+    int row = cell / boardSize;
+    int col = cell % boardSize;
+
+    //try the numbers in a random order so each thread and restart explores somewhere else
+    int order[MAX_SIZE];
+    for (int i = 0; i < boardSize; i++) {
+        int j = rand_r(&worker->seed) % (i + 1);
+        order[i] = order[j];
+        order[j] = i + 1;
+    }
+
+    for (int i = 0; i < boardSize; i++) {
+        if (worker->leavesLeft <= 0 || checkPatternStop(search)) {
+            worker->clues[row][col] = EMPTY;
+            return false;
+        }
+
+        int num = order[i];
+        if (!kernel->isValidShallow(row, col, num, worker->clues)) {
+            continue;
+        }
+        uint64_t hash = hashPattern(worker->prefix[depth], cell, num);
+        if (isExplored(search, hash)) {
+            __atomic_fetch_add(&search->skipped, 1, __ATOMIC_RELAXED);
+            continue;
+        }
+
+        //a capped count rejects fills without a solution before any deeper cell is tried
+        worker->clues[row][col] = num;
+        int count = 0;
+        kernel->getNumSolutions(0, 0, worker->clues, &count, 1);
+        if (count == 0) {
+            __atomic_fetch_add(&search->rejected, 1, __ATOMIC_RELAXED);
+            markExplored(search, hash);
+            continue;
+        }
+
+        //a fill whose whole subtree was searched never needs searching again, by this thread or another
+        worker->prefix[depth + 1] = hash;
+        if (fillPattern(worker, depth + 1)) {
+            markExplored(search, hash);
+        } else {
+            worker->clues[row][col] = EMPTY;
+            return false;
+        }
+    }
+
+    worker->clues[row][col] = EMPTY;
+    return true;
+}
+
+// checks if the limit or deadline was reached
+bool checkPatternStop(PatternSearch *search) {
+    if (__atomic_load_n(&search->stop, __ATOMIC_RELAXED)) {
+        return true;
+    }
+
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    bool timeUp = now.tv_sec > search->deadline.tv_sec || (now.tv_sec == search->deadline.tv_sec && now.tv_nsec >= search->deadline.tv_nsec);
+    if (timeUp || (search->limit > 0 && __atomic_load_n(&search->found, __ATOMIC_RELAXED) >= search->limit)) {
+        __atomic_store_n(&search->stop, true, __ATOMIC_RELAXED);
+        return true;
+    }
+    return false;
+}
+
+// checks if a partial fill is in the shared table
+bool isExplored(PatternSearch *search, uint64_t hash) {
+    for (int probe = 0; probe < PATTERN_PROBES; probe++) {
+        uint64_t slot = __atomic_load_n(&search->explored[(hash + probe) & (PATTERN_TABLE_SIZE - 1)], __ATOMIC_RELAXED);
+        if (slot == hash) {
+            return true;
+        }
+        if (slot == 0) {
+            return false;
+        }
+    }
+    return false;
+}
+
+// adds a partial fill to the shared table (returns false if it was already there or didn't fit)
+bool markExplored(PatternSearch *search, uint64_t hash) {
+    //lock-free linear probing, a full neighborhood just drops the entry (it only costs a repeated search, or a puzzle that isn't printed)
+    for (int probe = 0; probe < PATTERN_PROBES; probe++) {
+        uint64_t *slot = &search->explored[(hash + probe) & (PATTERN_TABLE_SIZE - 1)];
+        uint64_t empty = 0;
+        if (__atomic_compare_exchange_n(slot, &empty, hash, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+            return true;
+        }
+        if (empty == hash) {
+            return false;
+        }
+    }
+    return false;
+}
+
+// extends the hash of a partial fill with one more number
+uint64_t hashPattern(uint64_t prefix, int cell, int num) {
+    //splitmix64 finalizer, never 0 so it can't be mistaken for an empty slot
+    uint64_t x = prefix ^ ((uint64_t)(cell * (MAX_SIZE + 1) + num) * 0x9e3779b97f4a7c15ULL);
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return x | 1;
+}
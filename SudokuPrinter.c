@@ -1,26 +1,34 @@
 #include "SudokuDefinitions.h"
 #include "SudokuSolver.c"
+#include "SudokuSuggester.c"
+#include "SudokuVariant.c"
 #include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <time.h>
 
-// grid - 9x9 int array to hold contents of each cell in the sudoku board
-extern int grid[9][9];
-// given - 9x9 boolean array to hold the type of each cell (true = a given number, false = a penciled number)
-extern bool given[9][9];
-// correct - 9x9 boolean array to hold the validity of each cell (true = correct)
-extern bool correct[9][9];
+// grid - 2D int array to hold contents of each cell in the sudoku board (only the first boardSize rows and columns are used)
+extern int grid[MAX_SIZE][MAX_SIZE];
+// given - 2D boolean array to hold the type of each cell (true = a given number, false = a penciled number)
+extern bool given[MAX_SIZE][MAX_SIZE];
+// correct - 2D boolean array to hold the validity of each cell (true = correct)
+extern bool correct[MAX_SIZE][MAX_SIZE];
 // unique - boolean value to keep track of state of board (true = there is a unique solution, false = there are multiple solutions)
 extern bool unique;
 // solved - int value to keep track of state of the board (WRONG,CHECKED,CORRECT)
 extern int solved;
-// numGivens - int value to keep track of the number of givens inputted so far (at least 17 are needed for a unique solution)
+// numGivens - int value to keep track of the number of givens inputted so far (at least 17 are needed for a unique 9x9 solution)
 extern int numGivens;
 // inHelp - boolean value used to toggle the help page
 extern bool inHelp;
 // pencilMode - if true, all inputs are treated are no longer treated as givens
 extern bool pencilMode;
+// candidates - 2D array holding the numbers each empty cell takes in at least one solution (one bit per number)
+extern uint32_t candidates[MAX_SIZE][MAX_SIZE];
+// showCandidates - if true, the grid shows how many numbers each empty cell can still take
+extern bool showCandidates;
+// rendering - if false, the panel isn't printed (used to replay scripts without a terminal)
+extern bool rendering;
 
 // SudokuPrinter - contains the following functions to print the UI and send messages to the user
 void printTitle();                                        // prints header
@@ -34,8 +42,16 @@ void printUnableToUndoMessage();                          // prints error messag
 void printCantOverrideGivenMessage();                     // prints error message for when user attempts to change given cell in pencil mode
 void printUnableToEnterPencilModeMessage();               // prints error message for when user attempts to enter pencil mode for a non-unique board
 void printUnableToCheckMessage();                         // prints error message for when user attempts to check the board while not in pencil mode
+void printUnableToAddMessage();                           // prints error message for when user attempts to add a given that no solution allows
+void printUnableToReduceMessage();                        // prints error message for when user attempts to reduce a board without a unique solution
+void printUnableToGenerateMessage();                      // prints error message for when the variant rules allow no board to generate
+void printReducedMessage(int removed, bool minimal);      // prints how many givens the reduce command removed
+void printUnableToSuggestMessage();                       // prints error message for when user asks for suggestions on a board without multiple solutions
+void printSuggestions(Suggestion *suggestions, int num);  // prints the suggested givens and the solutions each leaves
 void printPrompt();                                       // prints default prompt message to enter cell(s)
 void printGrid();                                         // prints the sudoku board
+void printSeparator(int row);                             // prints the line above a row of the grid, bold along region outlines
+bool isOutline(int row1, int col1, int row2, int col2);  // checks if a region outline runs between two neighboring cells
 void printPanel();                                        // prints the default panel, including the title, grid, number of solutions, elapsed time, and prompt
 void printNumSolutions(int count);                        // prints blurb about solutions depending on count
 void printSolvingState();                                 // prints blurb about solution state of the board
@@ -79,8 +95,12 @@ void printHelpMessage() {
 
     printTitle();
     printBlue("The following are single letter commands that you can enter at any time:\n\n");
+    printf("a");
+    printGray(" - to add a random given that keeps the board solvable (not in pencil mode)\n");
     printf("c");
     printGray(" - to check the current board and highlight the incorrect cells (only in pencil mode)\n");
+    printf("d");
+    printGray(" - to drop every given the board doesn't need (board must be valid)\n");
     printf("e");
     printGray(" - to exit the program\n");
     printf("g");
@@ -89,6 +109,10 @@ void printHelpMessage() {
     printGray(" - to enter/exit this help screen\n");
     printf("m");
     printGray(" - to exit pencil mode (clears your pencil marks)\n");
+    printf("n");
+    printGray(" - to suggest the givens that cut down the number of solutions the most\n");
+    printf("o");
+    printGray(" - to show/hide how many numbers each empty cell can still take\n");
     printf("p");
     printGray(" - to enter pencil mode where you can attempt to solve the board yourself\n");
     printf("r");
@@ -144,6 +168,56 @@ void printUnableToCheckMessage() {
     printError("\nSorry, you can only check the board when you are in pencil mode.\n");
 }
 
+// prints error message for when user attempts to add a given that no solution allows
+void printUnableToAddMessage() {
+    printError("\nSorry, you can only add a given in make mode to a board that still has a solution.\n");
+}
+
+// prints error message for when user attempts to reduce a board without a unique solution
+void printUnableToReduceMessage() {
+    printError("\nSorry, you can only reduce a valid sudoku board (with exactly one solution) in make mode.\n");
+}
+
+// prints error message for when the variant rules allow no board to generate
+void printUnableToGenerateMessage() {
+    printError("\nSorry, the variant rules don't allow any solution, so there is no board to generate.\n");
+}
+
+// prints how many givens the reduce command removed
+void printReducedMessage(int removed, bool minimal) {
+    char *str = malloc(sizeof(char) * 100);
+    if (minimal) {
+        sprintf(str, "\nRemoved %d givens, every given left is needed for a unique solution.\n", removed);
+        printGreen(str);
+    } else {
+        sprintf(str, "\nRemoved %d givens, ran out of time before checking the rest (enter 'd' to continue).\n", removed);
+        printYellow(str);
+    }
+    free(str);
+}
+
+// prints error message for when user asks for suggestions on a board without multiple solutions
+void printUnableToSuggestMessage() {
+    printError("\nSorry, you can only get suggestions in make mode for a board with more than one solution.\n");
+}
+
+// prints the suggested givens and the solutions each leaves
+void printSuggestions(Suggestion *suggestions, int num) {
+    printBlue("\nSuggested givens:\n");
+    for (int i = 0; i < num; i++) {
+        Suggestion s = suggestions[i];
+        char *str = malloc(sizeof(char) * 60);
+        if (s.count == 1) {
+            sprintf(str, "  %c%d %d -> unique solution\n", s.row + 'A', s.col + 1, s.num);
+            printGreen(str);
+        } else {
+            sprintf(str, "  %c%d %d -> %d%s solutions\n", s.row + 'A', s.col + 1, s.num, s.count, s.count >= MAX_SOLUTIONS ? "+" : "");
+            printYellow(str);
+        }
+        free(str);
+    }
+}
+
 // prints default prompt message to enter cell(s)
 void printPrompt() {
     printf("Please enter a command or 1+ cells separated by spaces (ie 'A1 1 B2 2'): ");
@@ -156,26 +230,15 @@ void printGrid() {
     printf(" ");
 
     //print column numbers
-    for (int i = 0; i < 9; i++) {
-        printf("   %d", i + 1);
+    for (int i = 0; i < boardSize; i++) {
+        printf("%4d", i + 1);
     }
     printf("\n");
 
     //print grid
-    for (int row = 0; row < 9; ++row) {
-        //print top border of each row
-        if (row % 3 == 0) {
-            //if at the top row of a row group, print bold separator
-            printBold("  +-----------+-----------+-----------+\n");
-        } else {
-            //if an internal row of a row group, print thin separator
-            printBold("  |");
-            for (int i = 0; i < 3; ++i) {
-                printGray("---+---+---");
-                printBold("|");
-            }
-            printf("\n");
-        }
+    for (int row = 0; row < boardSize; ++row) {
+        //print top border of each row, bold where it follows a region outline
+        printSeparator(row);
 
         //print row letter
         printf("%c ", row + 'A');
@@ -184,14 +247,25 @@ void printGrid() {
         printBold("|");
 
         //print each cell in the row
-        for (int col = 0; col < 9; ++col) {
+        for (int col = 0; col < boardSize; ++col) {
             int num = grid[row][col];
 
             //format string to print in proper color
-            char *str = malloc(sizeof(char) * 3);
-            sprintf(str, " %d ", num);
-
-            if (num == EMPTY) {
+            char *str = malloc(sizeof(char) * 12);
+            sprintf(str, "%2d ", num);
+
+            if (num == EMPTY && showCandidates && !pencilMode) {
+                //if showing candidates, print how many numbers the cell can still take in yellow
+                sprintf(str, "%2d ", __builtin_popcount(candidates[row][col]));
+                printYellow(str);
+            } else if (num == EMPTY && cageLabel(row, col) > 0) {
+                //if cell starts a killer cage, print the cage's sum in green
+                sprintf(str, "%-3d", cageLabel(row, col));
+                printGreen(str);
+            } else if (num == EMPTY && variant != NULL && variant->diagonal && (row == col || row + col == boardSize - 1)) {
+                //if cell is on a diagonal that can't repeat a number, print the diagonal's direction
+                printGray(row + col == boardSize - 1 ? (row == col ? " X " : " / ") : " \\ ");
+            } else if (num == EMPTY) {
                 //if cell is not set, print empty space
                 printf("   ");
             } else if (given[row][col]) {
@@ -206,11 +280,14 @@ void printGrid() {
             }
             free(str);
 
-            if (col % 3 == 2) {
-                //if at the rightmost column of a column group, print bold separator
+            if (isOutline(row, col, row, col + 1)) {
+                //if at the edge of a region, print bold separator
                 printBold("|");
+            } else if (inSameCage(row, col, row, col + 1)) {
+                //if inside a killer cage, leave the cells open
+                printf(" ");
             } else {
-                //if an internal column of a column group, print thin separator
+                //if inside a region, print thin separator
                 printGray("|");
             }
         }
@@ -219,7 +296,52 @@ void printGrid() {
     }
 
     //print bottom border
-    printBold("  +-----------+-----------+-----------+\n\n");
+    printSeparator(boardSize);
+    printf("\n");
+}
+
+// prints the line above a row of the grid (boardSize = the bottom border), bold along region outlines
+void printSeparator(int row) {
+    printf("  ");
+    for (int col = 0; col <= boardSize; ++col) {
+        //the corner left of each cell joins the outlines that meet there
+        bool vertical = isOutline(row - 1, col - 1, row - 1, col) || isOutline(row, col - 1, row, col);
+        bool horizontal = (col > 0 && isOutline(row - 1, col - 1, row, col - 1)) || (col < boardSize && isOutline(row - 1, col, row, col));
+        if (vertical && horizontal) {
+            printBold("+");
+        } else if (vertical) {
+            printBold("|");
+        } else if (horizontal) {
+            printBold("-");
+        } else if (inSameCage(row - 1, col - 1, row, col) && inSameCage(row - 1, col, row, col - 1) && inSameCage(row - 1, col - 1, row - 1, col)) {
+            //the middle of a killer cage stays open
+            printf(" ");
+        } else {
+            printGray("+");
+        }
+
+        //then the edge above the cell
+        if (col == boardSize) {
+            break;
+        } else if (isOutline(row - 1, col, row, col)) {
+            printBold("---");
+        } else if (inSameCage(row - 1, col, row, col)) {
+            printf("   ");
+        } else {
+            printGray("---");
+        }
+    }
+    printf("\n");
+}
+
+// checks if a region outline runs between two neighboring cells (a cell off the board is outside every region)
+bool isOutline(int row1, int col1, int row2, int col2) {
+    bool inside1 = row1 >= 0 && row1 < boardSize && col1 >= 0 && col1 < boardSize;
+    bool inside2 = row2 >= 0 && row2 < boardSize && col2 >= 0 && col2 < boardSize;
+    if (!inside1 || !inside2) {
+        return inside1 != inside2;
+    }
+    return regionOf(row1, col1) != regionOf(row2, col2);
 }
 
 // prints the default panel, including the title, grid, number of solutions, elapsed time, and prompt
@@ -237,8 +359,8 @@ void printPanel() {
     //count = number of solutions
     int count = 0;
 
-    //only calculate number of solutions if there are at least 17 givens (17+ are needed for a unique solution)
-    if (numGivens >= 17 && !pencilMode) {
+    //only calculate number of solutions if there are enough givens (17+ are needed for a unique 9x9 solution)
+    if (numGivens >= kernel->minGivens && !pencilMode) {
         //set t to time when started calculation
         t = clock();
 
@@ -253,7 +375,21 @@ void printPanel() {
         validated = true;
     }
 
+    //find the candidates of each empty cell for the overlay (a board without solutions has none)
+    if (showCandidates && !pencilMode && rendering) {
+        getCandidates(candidates);
+    }
+
+    //without rendering only the solution count matters, as it decides whether the board just became unique
+    if (!rendering) {
+        if (!pencilMode && count == 1) {
+            unique = true;
+        }
+        return;
+    }
+
     //print panel
+    int span = profileBegin("render");
     printTitle();
     printGrid();
 
@@ -278,6 +414,7 @@ void printPanel() {
 
     //prompt user for cell input
     printPrompt();
+    profileEnd(span);
 }
 
 // prints blurb about solutions depending on count
@@ -285,10 +422,10 @@ void printNumSolutions(int count) {
     if (unique && count == 1) {
         //sudoku board was already valid
         printGreen("This is a valid sudoku board!\n");
-    } else if (numGivens < 17) {
+    } else if (numGivens < kernel->minGivens) {
         //not enough givens for a valid solution
         char *str = malloc(sizeof(char) * 70);
-        sprintf(str, "You need at least %d more numbers to make a valid sudoku board.\n", 17 - numGivens);
+        sprintf(str, "You need at least %d more numbers to make a valid sudoku board.\n", kernel->minGivens - numGivens);
         printYellow(str);
         free(str);
     } else if (!unique && count == 1) {
@@ -361,5 +498,8 @@ void printError(char *str) {
 
 // clears the console
 void clear() {
+    if (!rendering) {
+        return;
+    }
     system("clear");
 }
@@ -0,0 +1,241 @@
+#include "SudokuDefinitions.h"
+#include <errno.h>
+#include <linux/perf_event.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+// ProfileRecord - one finished span
+typedef struct {
+    const char *name;                    // what the span measured (ie 'count')
+    int depth;                           // number of spans it was nested in
+    uint64_t start;                      // nanoseconds since profiling started
+    uint64_t duration;                   // nanoseconds the span took
+    uint64_t counters[PROFILE_COUNTERS]; // hardware counter deltas (cycles, instructions, branch misses, L1 data misses)
+} ProfileRecord;
+
+// Profiler - spans recorded on the profiled thread
+typedef struct {
+    char *path;                                        // file the Chrome trace is written to
+    pthread_t thread;                                  // only spans on this thread are recorded (counters are per thread)
+    int fds[PROFILE_COUNTERS];                         // perf event of each counter (-1 if unavailable)
+    struct timespec origin;                            // time profiling started
+    ProfileRecord open[PROFILE_DEPTH];                 // spans started but not ended, innermost last
+    int depth;                                         // number of entries in open
+    ProfileRecord *records;                            // finished spans in the order they ended
+    int numRecords;                                    // number of entries in records
+    int capacity;                                      // size of records
+} Profiler;
+
+// profiler - NULL unless profiling was asked for with --profile
+Profiler *profiler = NULL;
+
+// names of the hardware counters, in the order of ProfileRecord.counters
+const char *counterNames[PROFILE_COUNTERS] = {"cycles", "instructions", "branch-misses", "L1d-misses"};
+
+// SudokuProfiler - contains the following functions to record spans of the solver and render calls with hardware counters
+void startProfiling(char *path);                             // opens the hardware counters and starts recording spans
+void finishProfiling();                                      // writes the Chrome trace and prints the summary table
+int profileBegin(const char *name);                          // starts a span (returns its handle for profileEnd, -1 if not recorded)
+void profileEnd(int span);                                   // ends the span started by profileBegin
+void readCounters(uint64_t *values);                         // reads the current value of each counter (0 if unavailable)
+uint64_t profileClock();                                     // nanoseconds since profiling started
+int openCounter(uint32_t type, uint64_t config, int leader); // opens one hardware counter in the group (returns -1 if unavailable)
+void writeTrace();                                           // writes every span as a Chrome trace event
+void printProfileSummary();                                  // prints the totals of each kind of span
+
+// opens the hardware counters and starts recording spans
+void startProfiling(char *path) {
+    profiler = calloc(1, sizeof(Profiler));
+    profiler->path = path;
+    profiler->thread = pthread_self();
+    profiler->capacity = 1024;
+    profiler->records = malloc(sizeof(ProfileRecord) * profiler->capacity);
+
+    //cycles leads the group so all counters cover exactly the same instructions
+    for (int i = 0; i < PROFILE_COUNTERS; i++) {
+        profiler->fds[i] = -1;
+    }
+    profiler->fds[0] = openCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES, -1);
+
+    if (profiler->fds[0] < 0) {
+        //without perf events (ie perf_event_paranoid or a container) the spans still get their times
+        fprintf(stderr, "Hardware counters unavailable (%s), recording times only.\n", strerror(errno));
+    } else {
+        //a counter the cpu doesn't support is left out of the group
+        profiler->fds[1] = openCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS, profiler->fds[0]);
+        profiler->fds[2] = openCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES, profiler->fds[0]);
+        profiler->fds[3] = openCounter(PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D | PERF_COUNT_HW_CACHE_OP_READ << 8 | PERF_COUNT_HW_CACHE_RESULT_MISS << 16, profiler->fds[0]);
+
+        ioctl(profiler->fds[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(profiler->fds[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &profiler->origin);
+}
+
+// writes the Chrome trace and prints the summary table
+void finishProfiling() {
+    if (profiler == NULL) {
+        return;
+    }
+    writeTrace();
+    printProfileSummary();
+
+    for (int i = 0; i < PROFILE_COUNTERS; i++) {
+        if (profiler->fds[i] >= 0) {
+            close(profiler->fds[i]);
+        }
+    }
+    free(profiler->records);
+    free(profiler);
+    profiler = NULL;
+}
+
+// starts a span (returns its handle for profileEnd, -1 if not recorded)
+int profileBegin(const char *name) {
+    if (profiler == NULL || !pthread_equal(pthread_self(), profiler->thread) || profiler->depth == PROFILE_DEPTH) {
+        return -1;
+    }
+
+    ProfileRecord *span = &profiler->open[profiler->depth];
+    span->name = name;
+    span->depth = profiler->depth;
+    span->start = profileClock();
+    readCounters(span->counters);
+    return profiler->depth++;
+}
+
+// ends the span started by profileBegin
+void profileEnd(int span) {
+    if (span < 0) {
+        return;
+    }
+
+    uint64_t now[PROFILE_COUNTERS];
+    readCounters(now);
+    ProfileRecord *record = &profiler->open[span];
+    record->duration = profileClock() - record->start;
+    for (int i = 0; i < PROFILE_COUNTERS; i++) {
+        record->counters[i] = now[i] - record->counters[i];
+    }
+    profiler->depth = span;
+
+    if (profiler->numRecords == profiler->capacity) {
+        profiler->capacity *= 2;
+        profiler->records = realloc(profiler->records, sizeof(ProfileRecord) * profiler->capacity);
+    }
+    profiler->records[profiler->numRecords++] = *record;
+}
+
+// reads the current value of each counter (0 if unavailable)
+void readCounters(uint64_t *values) {
+    memset(values, 0, sizeof(uint64_t) * PROFILE_COUNTERS);
+    if (profiler->fds[0] < 0) {
+        return;
+    }
+
+    //one read of the leader returns the whole group, in the order the counters were opened
+    uint64_t group[1 + PROFILE_COUNTERS];
+    if (read(profiler->fds[0], group, sizeof(group)) < (ssize_t)sizeof(uint64_t)) {
+        return;
+    }
+    int next = 1;
+    for (int i = 0; i < PROFILE_COUNTERS && next <= (int)group[0]; i++) {
+        if (profiler->fds[i] >= 0) {
+            values[i] = group[next++];
+        }
+    }
+}
+
+// nanoseconds since profiling started
+uint64_t profileClock() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)(now.tv_sec - profiler->origin.tv_sec) * 1000000000 + now.tv_nsec - profiler->origin.tv_nsec;
+}
+
+// opens one hardware counter in the group (returns -1 if unavailable)
+int openCounter(uint32_t type, uint64_t config, int leader) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.read_format = PERF_FORMAT_GROUP;
+    attr.disabled = leader < 0;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+
+    //count only this thread, on any cpu
+    return syscall(SYS_perf_event_open, &attr, 0, -1, leader, 0);
+}
+
+// writes every span as a Chrome trace event
+void writeTrace() {
+    FILE *file = fopen(profiler->path, "w");
+    if (file == NULL) {
+        perror(profiler->path);
+        return;
+    }
+
+    //complete events ('X') with times in microseconds, loadable in chrome://tracing or Perfetto
+    fprintf(file, "{\"traceEvents\":[\n");
+    for (int i = 0; i < profiler->numRecords; i++) {
+        ProfileRecord *r = &profiler->records[i];
+        fprintf(file, "{\"name\":\"%s\",\"cat\":\"sudoku\",\"ph\":\"X\",\"pid\":%d,\"tid\":1,\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"depth\":%d",
+                r->name, (int)getpid(), r->start / 1000.0, r->duration / 1000.0, r->depth);
+        for (int c = 0; c < PROFILE_COUNTERS; c++) {
+            if (profiler->fds[c] >= 0) {
+                fprintf(file, ",\"%s\":%llu", counterNames[c], (unsigned long long)r->counters[c]);
+            }
+        }
+        fprintf(file, "}}%s\n", i + 1 < profiler->numRecords ? "," : "");
+    }
+    fprintf(file, "],\"displayTimeUnit\":\"ns\"}\n");
+    fclose(file);
+}
+
+// prints the totals of each kind of span
+void printProfileSummary() {
+    fprintf(stderr, "\nspan                calls    total ms     mean us      cycles     IPC  br-miss/call  L1-miss/call\n");
+    for (int i = 0; i < profiler->numRecords; i++) {
+        //summarize each name once, at its first record
+        const char *name = profiler->records[i].name;
+        bool seen = false;
+        for (int j = 0; j < i && !seen; j++) {
+            seen = strcmp(profiler->records[j].name, name) == 0;
+        }
+        if (seen) {
+            continue;
+        }
+
+        int calls = 0;
+        uint64_t duration = 0, totals[PROFILE_COUNTERS] = {0};
+        for (int j = i; j < profiler->numRecords; j++) {
+            ProfileRecord *r = &profiler->records[j];
+            if (strcmp(r->name, name) == 0) {
+                calls++;
+                duration += r->duration;
+                for (int c = 0; c < PROFILE_COUNTERS; c++) {
+                    totals[c] += r->counters[c];
+                }
+            }
+        }
+
+        fprintf(stderr, "%-16s %8d %11.3f %11.3f", name, calls, duration / 1e6, duration / 1e3 / calls);
+        if (profiler->fds[0] >= 0) {
+            fprintf(stderr, " %11llu %7.2f %13.1f %13.1f\n", (unsigned long long)totals[0], totals[0] > 0 ? (double)totals[1] / totals[0] : 0.0,
+                    (double)totals[2] / calls, (double)totals[3] / calls);
+        } else {
+            fprintf(stderr, "           -       -             -             -\n");
+        }
+    }
+    fprintf(stderr, "\nWrote %d spans to %s.\n", profiler->numRecords, profiler->path);
+}
@@ -0,0 +1,316 @@
+#include "SudokuDefinitions.h"
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+// boardSize - int value holding the number of rows, columns, and digits in the board (9, 16, or 25)
+extern int boardSize;
+// boxSize - int value holding the number of rows and columns in each box (3, 4, or 5)
+extern int boxSize;
+
+// ReducerTest - one given being tested for removal on its own thread
+typedef struct {
+    pthread_t thread;
+    Snapshot *board;                    // board being reduced when the test started (shared by the tests of a batch)
+    int (*solution)[MAX_SIZE];          // unique solution of the board
+    int cell;                           // index of the given to remove
+    bool redundant;                     // true if the board is still unique without the given
+    int witness[MAX_SIZE][MAX_SIZE];    // another solution of the board without the given (if not redundant)
+    bool foundWitness;                  // true once witness holds a solution other than the unique one
+} ReducerTest;
+
+// Reducer - witnesses kept across the tests of a board
+typedef struct {
+    uint64_t (*witnesses)[SNAPSHOT_BOARD_WORDS]; // packed solutions of the board with some givens removed (never the unique solution)
+    int numWitnesses;                     // number of entries in witnesses
+} Reducer;
+
+// SudokuReducer - contains the following functions to strip redundant givens from a board with a unique solution
+int reduceBoard(int (*clues)[MAX_SIZE], int numThreads, int seconds, bool *minimal); // removes givens while the solution stays unique (returns how many, -1 if not unique)
+void *testRemoval(void *arg);                                                        // thread that checks whether the board stays unique without a given
+void keepWitness(ReducerTest *test, int (*found)[MAX_SIZE]);                         // saves the first solution that differs from the unique one
+void saveWitness(int (*found)[MAX_SIZE], void *data);                                // visitor for the capped count that passes each solution to keepWitness
+void saveSolution(int (*found)[MAX_SIZE], void *data);                               // visitor that copies the solution into the grid passed as data
+bool isBlocked(Reducer *reducer, int (*clues)[MAX_SIZE], int cell);                  // checks if a known witness already shows the given is needed
+int rankRemovals(int (*clues)[MAX_SIZE], int *order);                                // lists the givens in the order to try removing them
+int runReduceBatch(char *path, int numThreads);                                      // reduces every board in a file (one per line) and prints the results
+
+// removes givens while the solution stays unique (returns how many, -1 if not unique)
+// stops starting new tests after seconds (0 = no limit), minimal is set to true if every given left was shown to be needed
+int reduceBoard(int (*clues)[MAX_SIZE], int numThreads, int seconds, bool *minimal) {
+    *minimal = false;
+
+    //givens that break the rules leave no real solution
+    for (int row = 0; row < boardSize; row++) {
+        for (int col = 0; col < boardSize; col++) {
+            if (clues[row][col] != EMPTY && !kernel->isValidShallow(row, col, clues[row][col], clues)) {
+                return -1;
+            }
+        }
+    }
+
+    //find the unique solution (a board reduced before has it cached)
+    int solution[MAX_SIZE][MAX_SIZE];
+    int count = lookupCache(clues, 2, solution);
+    if (count < 0) {
+        count = 0;
+        kernel->forEachSolution(0, 0, clues, &count, 2, saveSolution, solution);
+        storeCache(clues, count, 2, count > 0 ? solution : NULL);
+    }
+    if (count != 1) {
+        return -1;
+    }
+
+    Reducer reducer = {0};
+    reducer.witnesses = malloc(sizeof(uint64_t[SNAPSHOT_BOARD_WORDS]) * boardSize * boardSize);
+    Snapshot *board = NULL;
+
+    int order[MAX_SIZE * MAX_SIZE];
+    int numLeft = rankRemovals(clues, order);
+    ReducerTest *tests = calloc(numThreads, sizeof(ReducerTest));
+    int removed = 0;
+
+    struct timespec deadline, now;
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+    deadline.tv_sec += seconds;
+
+    while (numLeft > 0) {
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        if (seconds > 0 && (now.tv_sec > deadline.tv_sec || (now.tv_sec == deadline.tv_sec && now.tv_nsec >= deadline.tv_nsec))) {
+            break;
+        }
+
+        //the tests copy the board from a snapshot (sharing the rows unchanged since the last batch)
+        Snapshot *current = takeSnapshot(clues, NULL, NULL, board);
+        releaseSnapshot(board);
+        board = current;
+
+        //start a batch of tests, skipping givens a witness already shows are needed
+        int batch = 0;
+        int next = 0;
+        while (next < numLeft && batch < numThreads) {
+            int cell = order[next++];
+            if (isBlocked(&reducer, clues, cell)) {
+                continue;
+            }
+            tests[batch].board = board;
+            tests[batch].solution = solution;
+            tests[batch].cell = cell;
+            pthread_create(&tests[batch].thread, NULL, testRemoval, &tests[batch]);
+            batch++;
+        }
+        for (int i = 0; i < batch; i++) {
+            pthread_join(tests[i].thread, NULL);
+        }
+
+        //every given in the batch is decided, only the givens after it still need testing
+        bool removedOne = false;
+        for (int i = 0; i < batch; i++) {
+            ReducerTest *test = &tests[i];
+            if (test->redundant && removedOne) {
+                //the others were tested with the earlier givens still there, so check each once more on the board as it is now
+                test->redundant = !isBlocked(&reducer, clues, test->cell);
+                if (test->redundant) {
+                    current = takeSnapshot(clues, NULL, NULL, board);
+                    releaseSnapshot(board);
+                    board = current;
+                    test->board = board;
+                    testRemoval(test);
+                }
+            }
+            if (!test->redundant) {
+                //needed now = needed on every smaller board, and its witness may rule out others
+                if (test->foundWitness) {
+                    packBoard(test->witness, reducer.witnesses[reducer.numWitnesses++]);
+                }
+            } else {
+                clues[test->cell / boardSize][test->cell % boardSize] = EMPTY;
+                removedOne = true;
+                removed++;
+            }
+        }
+        memmove(order, order + next, sizeof(int) * (numLeft - next));
+        numLeft -= next;
+    }
+
+    *minimal = numLeft == 0;
+    releaseSnapshot(board);
+    free(tests);
+    free(reducer.witnesses);
+    return removed;
+}
+
+// thread that checks whether the board stays unique without a given
+void *testRemoval(void *arg) {
+    ReducerTest *test = arg;
+    int work[MAX_SIZE][MAX_SIZE];
+    restoreSnapshot(test->board, work, NULL, NULL);
+    work[test->cell / boardSize][test->cell % boardSize] = EMPTY;
+
+    //a cached second solution is a witness without searching
+    int found[MAX_SIZE][MAX_SIZE];
+    int count = lookupCache(work, 2, found);
+    test->foundWitness = false;
+    if (count == 2) {
+        keepWitness(test, found);
+    }
+
+    //a second solution is enough to show the given is needed
+    if (count < 0 || (count == 2 && !test->foundWitness)) {
+        count = 0;
+        kernel->forEachSolution(0, 0, work, &count, 2, saveWitness, test);
+        storeCache(work, count, 2, test->foundWitness ? test->witness : test->solution);
+    }
+    test->redundant = count == 1;
+    return NULL;
+}
+
+// visitor for the capped count that passes each solution to keepWitness
+void saveWitness(int (*found)[MAX_SIZE], void *data) {
+    keepWitness(data, found);
+}
+
+// visitor that copies the solution into the grid passed as data
+void saveSolution(int (*found)[MAX_SIZE], void *data) {
+    memcpy(data, found, sizeof(int[MAX_SIZE][MAX_SIZE]));
+}
+
+// saves the first solution that differs from the unique one
+void keepWitness(ReducerTest *test, int (*found)[MAX_SIZE]) {
+    if (test->foundWitness) {
+        return;
+    }
+    for (int row = 0; row < boardSize; row++) {
+        if (memcmp(found[row], test->solution[row], sizeof(int) * boardSize) != 0) {
+            memcpy(test->witness, found, sizeof(test->witness));
+            test->foundWitness = true;
+            return;
+        }
+    }
+}
+
+// checks if a known witness already shows the given is needed
+bool isBlocked(Reducer *reducer, int (*clues)[MAX_SIZE], int cell) {
+    //the witnesses are compared packed, through a mask with every bit of the other givens set
+    int filled[MAX_SIZE][MAX_SIZE];
+    int allBits = boardSize < 16 ? 0xf : 0x1f;
+    for (int other = 0; other < boardSize * boardSize; other++) {
+        bool kept = other != cell && clues[other / boardSize][other % boardSize] != EMPTY;
+        filled[other / boardSize][other % boardSize] = kept ? allBits : 0;
+    }
+    uint64_t key[SNAPSHOT_BOARD_WORDS], mask[SNAPSHOT_BOARD_WORDS];
+    packBoard(clues, key);
+    packBoard(filled, mask);
+    int numWords = boardSize * packedRowWords();
+
+    //a witness that matches every other given is a second solution once this given is removed
+    for (int i = 0; i < reducer->numWitnesses; i++) {
+        bool matches = true;
+        for (int w = 0; w < numWords && matches; w++) {
+            matches = ((reducer->witnesses[i][w] ^ key[w]) & mask[w]) == 0;
+        }
+        if (matches) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// lists the givens in the order to try removing them
+int rankRemovals(int (*clues)[MAX_SIZE], int *order) {
+    //count the givens in each row, column, and box
+    int rows[MAX_SIZE] = {0}, cols[MAX_SIZE] = {0}, boxes[MAX_SIZE] = {0};
+    for (int row = 0; row < boardSize; row++) {
+        for (int col = 0; col < boardSize; col++) {
+            if (clues[row][col] != EMPTY) {
+                rows[row]++;
+                cols[col]++;
+                boxes[row / boxSize * boxSize + col / boxSize]++;
+            }
+        }
+    }
+
+    //givens in crowded units are the most likely to be redundant, so removing them first leaves fewer givens
+    int score[MAX_SIZE * MAX_SIZE];
+    int num = 0;
+    for (int row = 0; row < boardSize; row++) {
+        for (int col = 0; col < boardSize; col++) {
+            if (clues[row][col] != EMPTY) {
+                int cell = row * boardSize + col;
+                score[cell] = rows[row] + cols[col] + boxes[row / boxSize * boxSize + col / boxSize];
+
+                //insertion sort, highest score first
+                int i = num++;
+                while (i > 0 && score[order[i - 1]] < score[cell]) {
+                    order[i] = order[i - 1];
+                    i--;
+                }
+                order[i] = cell;
+            }
+        }
+    }
+    return num;
+}
+
+// reduces every board in a file (one per line) and prints the results
+int runReduceBatch(char *path, int numThreads) {
+    FILE *file = strcmp(path, "-") == 0 ? stdin : fopen(path, "r");
+    if (file == NULL) {
+        perror(path);
+        return 1;
+    }
+
+    int clues[MAX_SIZE][MAX_SIZE];
+    char *line = malloc(MAX_SIZE * MAX_SIZE + 64);
+    char *out = malloc(MAX_SIZE * MAX_SIZE + 1);
+    int numBoards = 0, givensBefore = 0, givensAfter = 0;
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    //stream the boards so whole corpora can be piped through
+    while (fgets(line, MAX_SIZE * MAX_SIZE + 64, file) != NULL) {
+        line[strcspn(line, "\r\n")] = '\0';
+        if (line[0] == '\0' || line[0] == '#') {
+            continue;
+        }
+
+        if (!parseBoard(line, clues, NULL)) {
+            printf("error invalid board\n");
+            continue;
+        }
+        int before = 0;
+        for (int i = 0; line[i] != '\0'; i++) {
+            before += line[i] != '.' && line[i] != '0';
+        }
+
+        bool minimal;
+        int removed = reduceBoard(clues, numThreads, 0, &minimal);
+        if (removed < 0) {
+            printf("error not unique\n");
+        } else {
+            formatBoard(clues, out);
+            printf("%s\n", out);
+            numBoards++;
+            givensBefore += before;
+            givensAfter += before - removed;
+        }
+        fflush(stdout);
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double seconds = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+    if (numBoards > 0) {
+        fprintf(stderr, "Reduced %d boards from %.1f to %.1f givens on average in %.3f seconds (%.3f ms each).\n", numBoards, (double)givensBefore / numBoards, (double)givensAfter / numBoards, seconds, seconds * 1000 / numBoards);
+    }
+
+    free(line);
+    free(out);
+    if (file != stdin) {
+        fclose(file);
+    }
+    return 0;
+}
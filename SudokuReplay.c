@@ -0,0 +1,163 @@
+#include "SudokuDefinitions.h"
+#include <fcntl.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+// inputStream - where commands and cell inputs are read from (stdin unless replaying a script)
+extern FILE *inputStream;
+// rendering - if false, the panel isn't printed (used to replay scripts without a terminal)
+extern bool rendering;
+// unique - boolean value to keep track of state of board (true = there is a unique solution, false = there are multiple solutions)
+extern bool unique;
+// numGivens - int value to keep track of the number of givens inputted so far (at least 17 are needed for a unique 9x9 solution)
+extern int numGivens;
+// pencilMode - if true, all inputs are treated are no longer treated as givens
+extern bool pencilMode;
+
+// SudokuMaker - the input handlers shared with the interactive mode
+void handleWord(char *input, bool *stop);
+void reset();
+
+// ReplayStep - one replayed command and how long it took
+typedef struct {
+    char text[32];  // command as written in the script (ie 'A1 8')
+    double seconds; // time taken to handle the command
+} ReplayStep;
+
+// SudokuReplay - contains the following functions to run command scripts without the interactive screens
+int runReplay(char *path);                                         // runs every command in the script and prints a summary
+void readScriptText(FILE *script, long start, char *text, int size); // copies the script text read since start, with whitespace collapsed
+void printReplaySummary(char *path, ReplayStep *steps, int numSteps); // prints the final board and the command timings
+
+// runs every command in the script and prints a summary
+int runReplay(char *path) {
+    FILE *script = fopen(path, "r");
+    if (script == NULL) {
+        perror(path);
+        return 1;
+    }
+
+    //read inputs from the script and skip drawing the panel
+    inputStream = script;
+    rendering = false;
+
+    //send the messages printed by the commands to /dev/null until the summary
+    fflush(stdout);
+    int terminal = dup(STDOUT_FILENO);
+    int devNull = open("/dev/null", O_WRONLY);
+    dup2(devNull, STDOUT_FILENO);
+    close(devNull);
+
+    reset();
+
+    int numSteps = 0, capacity = 64;
+    ReplayStep *steps = malloc(sizeof(ReplayStep) * capacity);
+    bool stop = false;
+    char input[32];
+    long start = ftell(script);
+
+    //loop until the script ends or runs the exit command 'e'
+    while (!stop && fscanf(script, "%31s", input) == 1) {
+        if (input[0] == '#') {
+            //skip comments
+            fscanf(script, "%*[^\n]");
+            start = ftell(script);
+            continue;
+        }
+
+        //time the same handling the interactive mode does (wall time, so waits on worker threads count too)
+        struct timespec begin, end;
+        clock_gettime(CLOCK_MONOTONIC, &begin);
+        handleWord(input, &stop);
+        clock_gettime(CLOCK_MONOTONIC, &end);
+
+        if (numSteps == capacity) {
+            capacity *= 2;
+            steps = realloc(steps, sizeof(ReplayStep) * capacity);
+        }
+        readScriptText(script, start, steps[numSteps].text, sizeof(steps[numSteps].text));
+        steps[numSteps].seconds = (end.tv_sec - begin.tv_sec) + (end.tv_nsec - begin.tv_nsec) / 1e9;
+        numSteps += 1;
+        start = ftell(script);
+    }
+    fclose(script);
+
+    //print the summary to the terminal again
+    fflush(stdout);
+    dup2(terminal, STDOUT_FILENO);
+    close(terminal);
+
+    printReplaySummary(path, steps, numSteps);
+    free(steps);
+    return 0;
+}
+
+// copies the script text read since start, with whitespace collapsed
+void readScriptText(FILE *script, long start, char *text, int size) {
+    long end = ftell(script);
+    fseek(script, start, SEEK_SET);
+
+    int len = 0;
+    bool space = false;
+    for (long i = start; i < end; i++) {
+        int c = fgetc(script);
+        if (c == ' ' || c == '\t' || c == '\n' || c == '\r') {
+            space = len > 0;
+        } else if (len < size - 2) {
+            if (space) {
+                text[len++] = ' ';
+                space = false;
+            }
+            text[len++] = c;
+        }
+    }
+    text[len] = '\0';
+
+    fseek(script, end, SEEK_SET);
+}
+
+// prints the final board and the command timings
+void printReplaySummary(char *path, ReplayStep *steps, int numSteps) {
+    printBold("Final board:\n");
+    printGrid();
+    printf("%d givens, %s, %s mode.\n\n", numGivens, unique ? "unique solution" : "not unique", pencilMode ? "pencil" : "make");
+
+    //time of each command
+    double total = 0;
+    printBold("   #  command       ms\n");
+    for (int i = 0; i < numSteps; i++) {
+        printf("%4d  %-10s %8.3f\n", i + 1, steps[i].text, steps[i].seconds * 1000);
+        total += steps[i].seconds;
+    }
+
+    //time of each kind of command (single letters and cell inputs)
+    printBold("\ncommand   count   total ms    mean ms     max ms\n");
+    for (int kind = 0; kind < 128; kind++) {
+        int count = 0;
+        double sum = 0, max = 0;
+        for (int i = 0; i < numSteps; i++) {
+            bool isCell = strlen(steps[i].text) > 1;
+            if ((kind == 0 && isCell) || (kind != 0 && !isCell && steps[i].text[0] == kind)) {
+                count += 1;
+                sum += steps[i].seconds;
+                max = steps[i].seconds > max ? steps[i].seconds : max;
+            }
+        }
+        if (count > 0) {
+            char name[8] = "cell";
+            if (kind != 0) {
+                sprintf(name, "%c", kind);
+            }
+            printf("%-7s %7d %10.3f %10.3f %10.3f\n", name, count, sum * 1000, sum * 1000 / count, max * 1000);
+        }
+    }
+
+    printf("\nReplayed %d commands from %s in %.5f seconds.\n", numSteps, path, total);
+    if (cache != NULL) {
+        printf("Solution cache: %lld hits, %lld misses.\n", cache->hits, cache->misses);
+    }
+}
@@ -0,0 +1,469 @@
+#include "SudokuDefinitions.h"
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// boardSize - int value holding the number of rows, columns, and digits in the board (9, 16, or 25)
+extern int boardSize;
+
+// SudokuMaker - the board generator shared with the interactive mode
+int genBoard(int (*grid)[MAX_SIZE], bool (*given)[MAX_SIZE]);
+// SudokuReducer - the visitor that copies a solution out of the search
+void saveSolution(int (*found)[MAX_SIZE], void *data);
+
+// ServerConnection - a client connection (responses are written back in the order the requests arrived)
+typedef struct {
+    int fd;                  // socket of the client
+    pthread_mutex_t lock;    // guards everything below
+    long nextWrite;          // sequence number of the next response to write
+    struct ServerJob *done;  // finished jobs waiting on an earlier response, sorted by sequence number
+    int pending;             // requests read but not yet answered
+    bool closed;             // true once the client stopped sending requests
+} ServerConnection;
+
+// ServerJob - one request line waiting for a worker
+typedef struct ServerJob {
+    ServerConnection *conn; // connection the request came from
+    long seq;               // position of the request on its connection
+    char *request;          // request line without the newline
+    char *response;         // response line with the newline (set by the worker)
+    struct ServerJob *next; // next job in the queue or in the connection's done list
+} ServerJob;
+
+// ServerWorker - a worker thread with its own board to search
+typedef struct {
+    pthread_t thread;
+    int grid[MAX_SIZE][MAX_SIZE];
+    bool given[MAX_SIZE][MAX_SIZE];
+    bool correct[MAX_SIZE][MAX_SIZE];
+} ServerWorker;
+
+// jobQueue - requests waiting for a worker (oldest first)
+ServerJob *jobQueue = NULL;
+// jobQueueTail - most recent request waiting for a worker
+ServerJob *jobQueueTail = NULL;
+// jobLock - guards the job queue
+pthread_mutex_t jobLock = PTHREAD_MUTEX_INITIALIZER;
+// jobReady - signalled when a request is added to the job queue
+pthread_cond_t jobReady = PTHREAD_COND_INITIALIZER;
+
+// SudokuServer - contains the following functions to answer solver requests over a socket
+int runServer(char *address, int numWorkers);                       // listens on a Unix socket path (or localhost port) until killed
+int openServerSocket(char *address);                                // binds and listens on the address
+void *serveConnection(void *arg);                                   // reads request lines from a client and queues them
+void *serveJobs(void *arg);                                         // worker loop that answers queued requests
+void queueJob(ServerJob *job);                                      // adds a request to the job queue
+void finishJob(ServerJob *job);                                     // writes a response once every earlier response on its connection is written
+void closeConnection(ServerConnection *conn);                       // closes the socket and frees the connection
+char *handleRequest(ServerWorker *worker, char *request);           // runs one request on the worker's board
+long long startBudget();                                            // limits the kernel searches of a request to SERVER_NODE_LIMIT cells
+bool endBudget(long long nodes);                                    // lifts the limit and returns true if a search gave up before finishing
+bool breaksRules(int (*grid)[MAX_SIZE]);                            // checks if two givens of a request clash (no search can solve the board)
+void writeAll(int fd, const char *str);                             // writes the whole string to the socket
+
+// listens on a Unix socket path (or localhost port) until killed
+int runServer(char *address, int numWorkers) {
+    //a client hanging up shouldn't take the server down with it
+    signal(SIGPIPE, SIG_IGN);
+
+    int fd = openServerSocket(address);
+    if (fd < 0) {
+        return 1;
+    }
+
+    //start the worker pool once, each worker keeps its own board
+    ServerWorker *workers = calloc(numWorkers, sizeof(ServerWorker));
+    for (int i = 0; i < numWorkers; i++) {
+        pthread_create(&workers[i].thread, NULL, serveJobs, &workers[i]);
+    }
+    fprintf(stderr, "Sudoku Maker is serving %dx%d boards on %s with %d workers.\n", boardSize, boardSize, address, numWorkers);
+
+    //hand each client to its own reader thread
+    while (true) {
+        int client = accept(fd, NULL, NULL);
+        if (client < 0) {
+            continue;
+        }
+
+        ServerConnection *conn = calloc(1, sizeof(ServerConnection));
+        conn->fd = client;
+        pthread_mutex_init(&conn->lock, NULL);
+
+        pthread_t reader;
+        if (pthread_create(&reader, NULL, serveConnection, conn) == 0) {
+            pthread_detach(reader);
+        } else {
+            close(client);
+            pthread_mutex_destroy(&conn->lock);
+            free(conn);
+        }
+    }
+}
+
+// binds and listens on the address
+int openServerSocket(char *address) {
+    int fd;
+    bool isPort = strspn(address, "0123456789") == strlen(address);
+
+    if (isPort) {
+        //all digits = localhost TCP port
+        struct sockaddr_in addr = {0};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(atoi(address));
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+        fd = socket(AF_INET, SOCK_STREAM, 0);
+        if (fd < 0) {
+            perror("socket");
+            return -1;
+        }
+        int on = 1;
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+        if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+            perror("bind");
+            close(fd);
+            return -1;
+        }
+    } else {
+        //anything else = Unix socket path
+        struct sockaddr_un addr = {0};
+        addr.sun_family = AF_UNIX;
+        if (strlen(address) >= sizeof(addr.sun_path)) {
+            fprintf(stderr, "Sorry, the socket path is too long.\n");
+            return -1;
+        }
+        strcpy(addr.sun_path, address);
+
+        //remove a socket left behind by a previous run, but never anything else at the path
+        struct stat info;
+        if (lstat(address, &info) == 0) {
+            if (!S_ISSOCK(info.st_mode)) {
+                fprintf(stderr, "Sorry, %s already exists and isn't a socket.\n", address);
+                return -1;
+            }
+            unlink(address);
+        }
+
+        fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd < 0) {
+            perror("socket");
+            return -1;
+        }
+        if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+            perror("bind");
+            close(fd);
+            return -1;
+        }
+    }
+
+    if (listen(fd, 64) < 0) {
+        perror("listen");
+        return -1;
+    }
+    return fd;
+}
+
+// reads request lines from a client and queues them
+void *serveConnection(void *arg) {
+    ServerConnection *conn = arg;
+    long seq = 0;
+
+    //requests are newline-delimited and may arrive split or batched across reads
+    size_t capacity = 4096, length = 0;
+    char *buffer = malloc(capacity);
+    ssize_t n;
+    while ((n = read(conn->fd, buffer + length, capacity - length)) > 0) {
+        length += n;
+
+        //queue every complete line
+        char *start = buffer;
+        char *end;
+        while ((end = memchr(start, '\n', buffer + length - start)) != NULL) {
+            *end = '\0';
+            if (end > start && end[-1] == '\r') {
+                end[-1] = '\0';
+            }
+
+            ServerJob *job = calloc(1, sizeof(ServerJob));
+            job->conn = conn;
+            job->seq = seq++;
+            job->request = strdup(start);
+
+            pthread_mutex_lock(&conn->lock);
+            conn->pending += 1;
+            pthread_mutex_unlock(&conn->lock);
+
+            queueJob(job);
+            start = end + 1;
+        }
+
+        //keep the unfinished line at the front of the buffer
+        length = buffer + length - start;
+        memmove(buffer, start, length);
+        if (length == capacity) {
+            capacity *= 2;
+            buffer = realloc(buffer, capacity);
+        }
+    }
+    free(buffer);
+
+    //stop reading, the connection is freed after the last response
+    pthread_mutex_lock(&conn->lock);
+    conn->closed = true;
+    bool finished = conn->pending == 0;
+    pthread_mutex_unlock(&conn->lock);
+
+    if (finished) {
+        closeConnection(conn);
+    }
+
+    return NULL;
+}
+
+// worker loop that answers queued requests
+void *serveJobs(void *arg) {
+    ServerWorker *worker = arg;
+
+    while (true) {
+        //wait for the next request
+        pthread_mutex_lock(&jobLock);
+        while (jobQueue == NULL) {
+            pthread_cond_wait(&jobReady, &jobLock);
+        }
+        ServerJob *job = jobQueue;
+        jobQueue = job->next;
+        if (jobQueue == NULL) {
+            jobQueueTail = NULL;
+        }
+        pthread_mutex_unlock(&jobLock);
+
+        job->response = handleRequest(worker, job->request);
+        finishJob(job);
+    }
+    return NULL;
+}
+
+// adds a request to the job queue
+void queueJob(ServerJob *job) {
+    pthread_mutex_lock(&jobLock);
+    job->next = NULL;
+    if (jobQueueTail == NULL) {
+        jobQueue = job;
+    } else {
+        jobQueueTail->next = job;
+    }
+    jobQueueTail = job;
+    pthread_cond_signal(&jobReady);
+    pthread_mutex_unlock(&jobLock);
+}
+
+// writes a response once every earlier response on its connection is written
+void finishJob(ServerJob *job) {
+    ServerConnection *conn = job->conn;
+
+    pthread_mutex_lock(&conn->lock);
+
+    //insert into the done list by sequence number
+    ServerJob **ptr = &conn->done;
+    while (*ptr != NULL && (*ptr)->seq < job->seq) {
+        ptr = &(*ptr)->next;
+    }
+    job->next = *ptr;
+    *ptr = job;
+
+    //write every response that is next in line
+    while (conn->done != NULL && conn->done->seq == conn->nextWrite) {
+        ServerJob *next = conn->done;
+        conn->done = next->next;
+        writeAll(conn->fd, next->response);
+        conn->nextWrite += 1;
+        conn->pending -= 1;
+        free(next->request);
+        free(next->response);
+        free(next);
+    }
+
+    //if the client already hung up, the last response frees the connection
+    bool finished = conn->closed && conn->pending == 0;
+    pthread_mutex_unlock(&conn->lock);
+
+    if (finished) {
+        closeConnection(conn);
+    }
+}
+
+// closes the socket and frees the connection
+void closeConnection(ServerConnection *conn) {
+    close(conn->fd);
+    pthread_mutex_destroy(&conn->lock);
+    free(conn);
+}
+
+// runs one request on the worker's board
+char *handleRequest(ServerWorker *worker, char *request) {
+    //longest response lists every cell of the board
+    char *response = malloc(4 * MAX_SIZE * MAX_SIZE + 64);
+    char command[16] = "";
+    char board[MAX_SIZE * MAX_SIZE + 2] = "";
+    char pencil[MAX_SIZE * MAX_SIZE + 2] = "";
+    int max = MAX_SOLUTIONS;
+
+    //request = command followed by up to two arguments (each at most MAX_SIZE * MAX_SIZE + 1 characters)
+    int numArgs = sscanf(request, "%15s %626s %626s", command, board, pencil);
+    if (numArgs < 1) {
+        strcpy(response, "error empty request\n");
+    } else if (strcmp(command, "generate") == 0) {
+        //generate: same board as the 'g' command
+        for (int row = 0; row < boardSize; row++) {
+            for (int col = 0; col < boardSize; col++) {
+                worker->grid[row][col] = EMPTY;
+                worker->given[row][col] = false;
+            }
+        }
+        if (genBoard(worker->grid, worker->given) < 0) {
+            strcpy(response, "error unsolvable\n");
+        } else {
+            strcpy(response, "ok ");
+            formatBoard(worker->grid, response + 3);
+            strcat(response, "\n");
+        }
+    } else if (strcmp(command, "solve") != 0 && strcmp(command, "count") != 0 && strcmp(command, "check") != 0) {
+        strcpy(response, "error unknown command\n");
+    } else if (numArgs < 2 || !parseBoard(board, worker->grid, worker->given)) {
+        strcpy(response, "error invalid board\n");
+    } else if (strcmp(command, "solve") == 0) {
+        //solve: fill the board with its first solution (or the one a previous request left in the cache)
+        int solution[MAX_SIZE][MAX_SIZE];
+        bool timedOut = false;
+        int count = breaksRules(worker->grid) ? 0 : lookupCache(worker->grid, 1, solution);
+        if (count < 0) {
+            //the fewest-candidates search copies out its first solution (every filled cell of a request is a given)
+            count = 0;
+            long long nodes = startBudget();
+            kernel->forEachSolution(0, 0, worker->grid, &count, 1, saveSolution, solution);
+            timedOut = endBudget(nodes);
+            if (!timedOut) {
+                storeCache(worker->grid, count, 1, count > 0 ? solution : NULL);
+            }
+        }
+        if (timedOut) {
+            strcpy(response, "error timeout\n");
+        } else if (count > 0) {
+            strcpy(response, "ok ");
+            formatBoard(solution, response + 3);
+            strcat(response, "\n");
+        } else {
+            strcpy(response, "error unsolvable\n");
+        }
+    } else if (strcmp(command, "count") == 0) {
+        //count: number of solutions up to the max (defaults to the interactive limit)
+        if (numArgs == 3) {
+            max = atoi(pencil);
+        }
+        if (max < 1) {
+            strcpy(response, "error invalid max\n");
+        } else {
+            bool timedOut = false;
+            int count = breaksRules(worker->grid) ? 0 : lookupCache(worker->grid, max, NULL);
+            if (count < 0) {
+                count = 0;
+                long long nodes = startBudget();
+                kernel->getNumSolutions(0, 0, worker->grid, &count, max);
+                timedOut = endBudget(nodes);
+                if (!timedOut) {
+                    storeCache(worker->grid, count, max, NULL);
+                }
+            }
+            if (timedOut) {
+                strcpy(response, "error timeout\n");
+            } else {
+                sprintf(response, "ok %d%s\n", count, count >= max ? "+" : "");
+            }
+        }
+    } else {
+        //check: fill in the pencil marks over the givens and mark the wrong cells
+        int pencilGrid[MAX_SIZE][MAX_SIZE];
+        if (numArgs < 3 || !parseBoard(pencil, pencilGrid, NULL)) {
+            strcpy(response, "error invalid pencil marks\n");
+        } else {
+            for (int row = 0; row < boardSize; row++) {
+                for (int col = 0; col < boardSize; col++) {
+                    if (!worker->given[row][col]) {
+                        worker->grid[row][col] = pencilGrid[row][col];
+                    }
+                    worker->correct[row][col] = true;
+                }
+            }
+
+            int state = CORRECT;
+            long long nodes = startBudget();
+            bool found = kernel->markSolution(0, 0, worker->grid, worker->given, worker->correct, &state);
+            if (endBudget(nodes)) {
+                strcpy(response, "error timeout\n");
+            } else if (!found) {
+                strcpy(response, "error unsolvable\n");
+            } else if (state == CORRECT) {
+                strcpy(response, "ok correct\n");
+            } else {
+                //list the wrong and empty cells (ie 'A1 C12')
+                int len = sprintf(response, "ok wrong");
+                for (int row = 0; row < boardSize; row++) {
+                    for (int col = 0; col < boardSize; col++) {
+                        if (!worker->correct[row][col]) {
+                            len += sprintf(response + len, " %c%d", 'A' + row, col + 1);
+                        }
+                    }
+                }
+                strcpy(response + len, "\n");
+            }
+        }
+    }
+    return response;
+}
+
+// limits the kernel searches on this thread to SERVER_NODE_LIMIT cells and returns the node count to measure them from
+long long startBudget() {
+    kernelNodeLimit = SERVER_NODE_LIMIT;
+    return kernelNodes;
+}
+
+// lifts the limit again and returns true if a search since startBudget gave up before finishing
+bool endBudget(long long nodes) {
+    kernelNodeLimit = LLONG_MAX;
+    return kernelNodes - nodes > SERVER_NODE_LIMIT;
+}
+
+// checks if two givens of a request clash (no search can solve the board, but it could spend ages proving it)
+bool breaksRules(int (*grid)[MAX_SIZE]) {
+    for (int row = 0; row < boardSize; row++) {
+        for (int col = 0; col < boardSize; col++) {
+            if (grid[row][col] != EMPTY && !kernel->isValidShallow(row, col, grid[row][col], grid)) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+// writes the whole string to the socket
+void writeAll(int fd, const char *str) {
+    size_t length = strlen(str);
+    while (length > 0) {
+        ssize_t n = write(fd, str, length);
+        if (n <= 0) {
+            //client is gone, drop the rest of the response
+            return;
+        }
+        str += n;
+        length -= n;
+    }
+}
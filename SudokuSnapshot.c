@@ -0,0 +1,169 @@
+#include "SudokuDefinitions.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+// boardSize - int value holding the number of rows, columns, and digits in the board (9, 16, or 25)
+extern int boardSize;
+
+// PackedRow - one row of a snapshot, shared by every snapshot the row is unchanged in
+typedef struct {
+    int refs;                           // number of snapshots holding the row
+    uint64_t cells[SNAPSHOT_ROW_WORDS]; // numbers of the row, 4 bits each (5 bits for boards past 15x15)
+    uint32_t given;                     // bit per column set if the cell is a given
+    uint32_t correct;                   // bit per column set if the cell is correct
+} PackedRow;
+
+// Snapshot - an immutable packed copy of the board (rows are copy-on-write, so a snapshot after one edit only allocates its row table and one row)
+typedef struct {
+    int refs;                           // number of holders of the snapshot (freed when it reaches 0)
+    int size;                           // board size the snapshot was taken at
+    PackedRow *rows[MAX_SIZE];          // packed rows, possibly shared with other snapshots
+} Snapshot;
+
+// SudokuSnapshot - contains the following functions to copy boards into compact snapshots that share unchanged rows, and to pack and hash boards the same way elsewhere
+Snapshot *takeSnapshot(int (*grid)[MAX_SIZE], bool (*given)[MAX_SIZE], bool (*correct)[MAX_SIZE], Snapshot *previous); // packs a board, sharing the rows unchanged since the previous snapshot (NULL = none, given and correct may be NULL)
+void restoreSnapshot(Snapshot *snapshot, int (*grid)[MAX_SIZE], bool (*given)[MAX_SIZE], bool (*correct)[MAX_SIZE]);  // unpacks a snapshot into the arrays (given and correct may be NULL)
+Snapshot *retainSnapshot(Snapshot *snapshot);                                 // adds a holder to the snapshot and returns it
+void releaseSnapshot(Snapshot *snapshot);                                     // drops a holder, freeing the snapshot and its unshared rows after the last one
+void packRow(int *nums, bool *given, bool *correct, PackedRow *row);          // packs a row of the board (the refs are left untouched, given and correct may be NULL)
+void unpackRow(PackedRow *row, int size, int *nums, bool *given, bool *correct); // unpacks a row packed at the size (given and correct may be NULL)
+int packedRowWords();                                                         // returns the words a packed row of the current board size uses
+void packBoard(int (*grid)[MAX_SIZE], uint64_t *words);                       // packs the numbers of a board into words, row after row like a snapshot
+void unpackBoard(uint64_t *words, int (*grid)[MAX_SIZE]);                     // unpacks words from packBoard into the numbers of a board
+uint64_t hashPacked(uint64_t *words, int numWords);                           // hashes packed words (never 0, so it can mark an empty slot)
+
+// packs a board, sharing the rows unchanged since the previous snapshot (NULL = none, given and correct may be NULL)
+Snapshot *takeSnapshot(int (*grid)[MAX_SIZE], bool (*given)[MAX_SIZE], bool (*correct)[MAX_SIZE], Snapshot *previous) {
+    if (previous != NULL && previous->size != boardSize) {
+        previous = NULL;
+    }
+
+    Snapshot *snapshot = malloc(sizeof(Snapshot));
+    snapshot->refs = 1;
+    snapshot->size = boardSize;
+    bool changed = previous == NULL;
+
+    for (int row = 0; row < boardSize; row++) {
+        PackedRow packed;
+        packRow(grid[row], given != NULL ? given[row] : NULL, correct != NULL ? correct[row] : NULL, &packed);
+
+        //a row that didn't change is shared instead of copied
+        PackedRow *old = previous != NULL ? previous->rows[row] : NULL;
+        if (old != NULL && old->given == packed.given && old->correct == packed.correct && memcmp(old->cells, packed.cells, sizeof(packed.cells)) == 0) {
+            __atomic_fetch_add(&old->refs, 1, __ATOMIC_RELAXED);
+            snapshot->rows[row] = old;
+        } else {
+            snapshot->rows[row] = malloc(sizeof(PackedRow));
+            *snapshot->rows[row] = packed;
+            snapshot->rows[row]->refs = 1;
+            changed = true;
+        }
+    }
+
+    //an unchanged board is the previous snapshot itself
+    if (!changed) {
+        releaseSnapshot(snapshot);
+        return retainSnapshot(previous);
+    }
+    return snapshot;
+}
+
+// unpacks a snapshot into the arrays (given and correct may be NULL)
+void restoreSnapshot(Snapshot *snapshot, int (*grid)[MAX_SIZE], bool (*given)[MAX_SIZE], bool (*correct)[MAX_SIZE]) {
+    for (int row = 0; row < snapshot->size; row++) {
+        unpackRow(snapshot->rows[row], snapshot->size, grid[row], given != NULL ? given[row] : NULL, correct != NULL ? correct[row] : NULL);
+    }
+}
+
+// adds a holder to the snapshot and returns it
+Snapshot *retainSnapshot(Snapshot *snapshot) {
+    __atomic_fetch_add(&snapshot->refs, 1, __ATOMIC_RELAXED);
+    return snapshot;
+}
+
+// drops a holder, freeing the snapshot and its unshared rows after the last one
+void releaseSnapshot(Snapshot *snapshot) {
+    if (snapshot == NULL || __atomic_sub_fetch(&snapshot->refs, 1, __ATOMIC_ACQ_REL) > 0) {
+        return;
+    }
+    for (int row = 0; row < snapshot->size; row++) {
+        if (__atomic_sub_fetch(&snapshot->rows[row]->refs, 1, __ATOMIC_ACQ_REL) == 0) {
+            free(snapshot->rows[row]);
+        }
+    }
+    free(snapshot);
+}
+
+// packs a row of the board (the refs are left untouched, given and correct may be NULL)
+void packRow(int *nums, bool *given, bool *correct, PackedRow *row) {
+    int bits = boardSize < 16 ? 4 : 5;
+    int perWord = 64 / bits;
+    memset(row->cells, 0, sizeof(row->cells));
+    row->given = 0;
+    row->correct = 0;
+    for (int col = 0; col < boardSize; col++) {
+        row->cells[col / perWord] |= (uint64_t)nums[col] << (col % perWord * bits);
+        if (given != NULL) {
+            row->given |= (uint32_t)given[col] << col;
+        }
+        if (correct != NULL) {
+            row->correct |= (uint32_t)correct[col] << col;
+        }
+    }
+}
+
+// unpacks a row packed at the size (given and correct may be NULL)
+void unpackRow(PackedRow *row, int size, int *nums, bool *given, bool *correct) {
+    int bits = size < 16 ? 4 : 5;
+    int perWord = 64 / bits;
+    for (int col = 0; col < size; col++) {
+        nums[col] = row->cells[col / perWord] >> (col % perWord * bits) & ((1 << bits) - 1);
+        if (given != NULL) {
+            given[col] = row->given >> col & 1;
+        }
+        if (correct != NULL) {
+            correct[col] = row->correct >> col & 1;
+        }
+    }
+}
+
+// returns the words a packed row of the current board size uses
+int packedRowWords() {
+    int perWord = 64 / (boardSize < 16 ? 4 : 5);
+    return (boardSize + perWord - 1) / perWord;
+}
+
+// packs the numbers of a board into words, row after row like a snapshot
+void packBoard(int (*grid)[MAX_SIZE], uint64_t *words) {
+    int rowWords = packedRowWords();
+    for (int row = 0; row < boardSize; row++) {
+        PackedRow packed;
+        packRow(grid[row], NULL, NULL, &packed);
+        memcpy(words + row * rowWords, packed.cells, rowWords * sizeof(uint64_t));
+    }
+}
+
+// unpacks words from packBoard into the numbers of a board
+void unpackBoard(uint64_t *words, int (*grid)[MAX_SIZE]) {
+    int rowWords = packedRowWords();
+    for (int row = 0; row < boardSize; row++) {
+        PackedRow packed;
+        memcpy(packed.cells, words + row * rowWords, rowWords * sizeof(uint64_t));
+        unpackRow(&packed, boardSize, grid[row], NULL, NULL);
+    }
+}
+
+// hashes packed words (never 0, so it can mark an empty slot)
+uint64_t hashPacked(uint64_t *words, int numWords) {
+    //FNV-1a over the words, then the splitmix64 finalizer so the low and high bits depend on every cell
+    uint64_t x = 0xcbf29ce484222325ULL;
+    for (int i = 0; i < numWords; i++) {
+        x = (x ^ words[i]) * 0x100000001b3ULL;
+    }
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return x | 1;
+}
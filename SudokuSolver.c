@@ -1,158 +1,127 @@
 #include "SudokuDefinitions.h"
+#include "SudokuProfiler.c"
+#include <limits.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdio.h>
 
-// grid - 9x9 int array to hold contents of each cell in the sudoku board
-extern int grid[9][9];
-// given - 9x9 boolean array to hold the type of each cell (true = a given number, false = a penciled number)
-extern bool given[9][9];
-// correct - 9x9 boolean array to hold the validity of each cell (true = correct)
-extern bool correct[9][9];
+// grid - 2D int array to hold contents of each cell in the sudoku board (only the first boardSize rows and columns are used)
+extern int grid[MAX_SIZE][MAX_SIZE];
+// given - 2D boolean array to hold the type of each cell (true = a given number, false = a penciled number)
+extern bool given[MAX_SIZE][MAX_SIZE];
+// correct - 2D boolean array to hold the validity of each cell (true = correct)
+extern bool correct[MAX_SIZE][MAX_SIZE];
 // solved - int value to keep track of state of the board (WRONG,CHECKED,CORRECT)
 extern int solved;
+// boardSize - int value holding the number of rows, columns, and digits in the board (9, 16, or 25)
+extern int boardSize;
+// boxSize - int value holding the number of rows and columns in each box (3, 4, or 5)
+extern int boxSize;
+
+// SudokuKernel - the solver functions specialized for a single board size (generated by SudokuKernel.c)
+typedef struct {
+    int box;       // number of rows and columns in each box
+    int size;      // number of rows, columns, and digits in the board
+    int minGivens; // fewest givens seen in a board with a unique solution (no point counting solutions below this)
+    bool (*genSolution)(int row, int col, int (*grid)[MAX_SIZE], bool (*given)[MAX_SIZE]);
+    bool (*markSolution)(int row, int col, int (*grid)[MAX_SIZE], bool (*given)[MAX_SIZE], bool (*correct)[MAX_SIZE], int *solved);
+    void (*getNumSolutions)(int row, int col, int (*grid)[MAX_SIZE], int *count, int max);
+    bool (*isValidShallow)(int row, int col, int num, int (*grid)[MAX_SIZE]);
+    bool (*getCandidates)(int (*grid)[MAX_SIZE], uint32_t (*candidates)[MAX_SIZE]);
+    void (*forEachSolution)(int row, int col, int (*grid)[MAX_SIZE], int *count, int max, void (*visit)(int (*grid)[MAX_SIZE], void *data), void *data);
+} SudokuKernel;
+
+// kernelNodes - cells tried by the kernels on this thread so far (lets the fuzz harness catch searches that got bigger)
+__thread long long kernelNodes = 0;
+
+// kernelNodeLimit - cells a single kernel search on this thread may try before it gives up (the server lowers it per request)
+__thread long long kernelNodeLimit = LLONG_MAX;
+
+#define KERNEL_BOX 3
+#define KERNEL_SIZE 9
+#define KERNEL_MASK uint16_t
+#include "SudokuKernel.c"
+
+#define KERNEL_BOX 4
+#define KERNEL_SIZE 16
+#define KERNEL_MASK uint16_t
+#include "SudokuKernel.c"
+
+#define KERNEL_BOX 5
+#define KERNEL_SIZE 25
+#define KERNEL_MASK uint32_t
+#include "SudokuKernel.c"
+
+// kernels - one specialized solver per supported board size
+const SudokuKernel kernels[] = {
+    {3, 9, 17, genSolution9, markSolution9, getNumSolutions9, isValidShallow9, getCandidates9, forEachSolution9},
+    {4, 16, 55, genSolution16, markSolution16, getNumSolutions16, isValidShallow16, getCandidates16, forEachSolution16},
+    {5, 25, 151, genSolution25, markSolution25, getNumSolutions25, isValidShallow25, getCandidates25, forEachSolution25},
+};
+// kernel - the solver for the board size selected at startup
+const SudokuKernel *kernel = &kernels[0];
+
+#include "SudokuSnapshot.c"
+#include "SudokuCache.c"
+#include "SudokuIncremental.c"
 
 // SudokuSolver - contains the following functions to handle all validations and calculations
+bool selectKernel(int size);                                 // picks the specialized solver for the board size
 bool genSolution(int row, int col);                          // resolves the board with recursive backtracking
 bool markSolution(int row, int col);                         // marks incorrect cells with recursive backtracking
 void getNumSolutions(int row, int col, int *count, int max); // calculates the number of solutions of the current board (up to the max) with recursive backtracking
 void getNumErrors(int *errors, int *emptyCells);             // counts the number of errors and empty cells in the current board
 bool isValidShallow(int row, int col, int num);              // does a shallow check of the cell (verifies it is unique within the row, column, and box)
 bool isValidDeep(int row, int col, int num);                 // does a deep check of the cell (verifies there is at least one solution)
-
-// resolves the board with recursive backtracking
-bool genSolution(int row, int col) {
-    //base case: reached the end of the board -> solved
-    if (row == 8 && col == 9) {
-        return true;
-    }
-
-    //if column overflow, move to next row
-    if (col == 9) {
-        col = 0;
-        row += 1;
-    }
-
-    if (!given[row][col]) {
-        //if cell is empty, try each number 1-9
-        for (int i = 0; i < 9; i++) {
-            //check if setting this will immediately break the puzzle
-            if (isValidShallow(row, col, i + 1)) {
-                //assume temporarily this number is right
-                grid[row][col] = i + 1;
-
-                //recursively check the next cell
-                if (genSolution(row, col + 1)) {
-                    //if found a solution, stop the recursion
-                    return true;
-                }
-            }
+bool getCandidates(uint32_t (*candidates)[MAX_SIZE]);        // finds the numbers each empty cell takes in at least one solution (one bit per number)
+
+// picks the specialized solver for the board size
+bool selectKernel(int size) {
+    for (int i = 0; i < (int)(sizeof(kernels) / sizeof(kernels[0])); i++) {
+        if (kernels[i].size == size) {
+            kernel = &kernels[i];
+            boardSize = kernel->size;
+            boxSize = kernel->box;
+            return true;
         }
+    }
 
-        //if didn't find a solution, reset the cell
-        grid[row][col] = EMPTY;
+    //no solver for this size
+    return false;
+}
 
-        //return to parent for backtracking
-        return false;
-    } else {
-        //if cell is already filled, skip it
-        return genSolution(row, col + 1);
-    }
+// resolves the board with recursive backtracking
+bool genSolution(int row, int col) {
+    int span = profileBegin("solve");
+    bool found = kernel->genSolution(row, col, grid, given);
+    profileEnd(span);
+    return found;
 }
 
 // marks incorrect cells with recursive backtracking
 bool markSolution(int row, int col) {
-    //base case: reached the end of the board -> solved
-    if (row == 8 && col == 9) {
-        return true;
-    }
-
-    //if column overflow, move to next row
-    if (col == 9) {
-        col = 0;
-        row += 1;
-    }
-
-    if (!given[row][col]) {
-        //save initial number
-        int prev = grid[row][col];
-
-        //if cell is not given, try each number 1-9
-        for (int i = 0; i < 9; i++) {
-            //check if setting this will immediately break the puzzle
-            if (isValidShallow(row, col, i + 1)) {
-                //assume temporarily this number is right
-                grid[row][col] = i + 1;
-
-                //recursively check the next cell
-                if (markSolution(row, col + 1)) {
-                    //if found a solution, compare to the initial value
-                    if (prev != i + 1) {
-                        //if not correct, update correct array and revert cell
-                        correct[row][col] = false;
-                        solved = WRONG;
-                    }
-                    grid[row][col] = prev;
-                    return true;
-                }
-            }
-        }
-
-        //if didn't find a solution, reset the cell
-        grid[row][col] = prev;
-
-        //return to parent for backtracking
-        return false;
-    } else {
-        //if cell is already filled, skip it
-        return markSolution(row, col + 1);
-    }
+    int span = profileBegin("mark");
+    bool found = kernel->markSolution(row, col, grid, given, correct, &solved);
+    profileEnd(span);
+    return found;
 }
 
 // calculates the number of solutions of the current board (up to the max) with recursive backtracking
 void getNumSolutions(int row, int col, int *count, int max) {
-    //base case: reached the end of the board -> solved
-    if (row == 8 && col == 9) {
-        //increase solution counter
-        *count += 1;
-        return;
-    }
-
-    //if column overflow, move to next row
-    if (col == 9) {
-        col = 0;
-        row += 1;
-    }
-
-    if (grid[row][col] == EMPTY) {
-        //if cell is empty, try each number 1-9
-        for (int i = 0; i < 9; i++) {
-            //check if setting this will immediately break the puzzle
-            if (isValidShallow(row, col, i + 1)) {
-                //assume temporarily this number is right
-                grid[row][col] = i + 1;
-
-                //recursively check the next cell
-                getNumSolutions(row, col + 1, count, max);
-
-                //reset the cell
-                grid[row][col] = EMPTY;
-
-                //if reached the maximum solution count, stop the recursion
-                if (*count >= max) {
-                    return;
-                }
-            }
-        }
+    int span = profileBegin("count");
+    if (row == 0 && col == 0) {
+        //counts of the whole board reuse what the previous counts found
+        *count += countIncremental(grid, max);
     } else {
-        //if cell is already filled, skip it
-        getNumSolutions(row, col + 1, count, max);
+        kernel->getNumSolutions(row, col, grid, count, max);
     }
+    profileEnd(span);
 }
 
 // counts the number of errors and empty cells in the current board
 void getNumErrors(int *errors, int *emptyCells) {
-    for (int row = 0; row < 9; row++) {
-        for (int col = 0; col < 9; col++) {
+    for (int row = 0; row < boardSize; row++) {
+        for (int col = 0; col < boardSize; col++) {
             if (!correct[row][col]) {
                 if (grid[row][col] == EMPTY) {
                     *emptyCells += 1;
@@ -166,36 +135,21 @@ void getNumErrors(int *errors, int *emptyCells) {
 
 // does a shallow check of the cell (verifies it is unique within the row, column, and box)
 bool isValidShallow(int row, int col, int num) {
-    //check for duplicate values in the same row and column
-    for (int i = 0; i < 9; i++) {
-        if (col != i && grid[row][i] == num)
-            return false;
-        if (row != i && grid[i][col] == num) {
-            return false;
-        }
-    }
-
-    //calculate the first row and column in the cell's box
-    int startRow = row / 3 * 3;
-    int startCol = col / 3 * 3;
-
-    //check for duplicates in the same box
-    for (int r = 0; r < 3; r++) {
-        for (int c = 0; c < 3; c++) {
-            if (!(startRow + r == row && startCol + c == col) && grid[startRow + r][startCol + c] == num)
-                return false;
-        }
-    }
-
-    //cell passed shallow tests
-    return true;
+    int span = profileBegin("validate shallow");
+    bool valid = kernel->isValidShallow(row, col, num, grid);
+    profileEnd(span);
+    return valid;
 }
 
 // does a deep check of the cell (verifies there is at least one solution)
 bool isValidDeep(int row, int col, int num) {
+    int span = profileBegin("validate deep");
+
     //do shallow check first
-    if (!isValidShallow(row, col, num))
+    if (!isValidShallow(row, col, num)) {
+        profileEnd(span);
         return false;
+    }
 
     //do deep check if passed shallow check
     //save current value of the grid
@@ -204,13 +158,30 @@ bool isValidDeep(int row, int col, int num) {
     //assume temporarily the cell was updated
     grid[row][col] = num;
 
-    //verify there is at least one solution with this assumption
-    int count = 0;
-    getNumSolutions(0, 0, &count, 1); //will return 0 or 1 because set max of 1
+    //verify there is at least one solution with this assumption, from the stored solutions and nogoods if they can tell
+    int count = checkIncremental(grid);
+    if (count < 0) {
+        count = 0;
+        kernel->getNumSolutions(0, 0, grid, &count, 1); //will return 0 or 1 because set max of 1
+        if (count == 0) {
+            learnNogood(grid);
+        }
+    }
 
     //reset the grid value
     grid[row][col] = previous;
+    profileEnd(span);
 
     //return true if there was at least one solution
     return count == 1;
+}
+
+// finds the numbers each empty cell takes in at least one solution (one bit per number)
+bool getCandidates(uint32_t (*candidates)[MAX_SIZE]) {
+    //a single search that reuses each solution found for every cell, instead of a deep check per cell and number
+    int span = profileBegin("candidates");
+    int stored = candidatesIncremental(grid, candidates);
+    bool found = stored >= 0 ? stored == 1 : kernel->getCandidates(grid, candidates);
+    profileEnd(span);
+    return found;
 }
\ No newline at end of file
@@ -0,0 +1,175 @@
+#include "SudokuDefinitions.h"
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+// grid - 2D int array to hold contents of each cell in the sudoku board (only the first boardSize rows and columns are used)
+extern int grid[MAX_SIZE][MAX_SIZE];
+// boardSize - int value holding the number of rows, columns, and digits in the board (9, 16, or 25)
+extern int boardSize;
+
+// Suggestion - a given to add and how many solutions the board has with it
+typedef struct {
+    int row;
+    int col;
+    int num;
+    int count; // number of solutions with the given added (MAX_SOLUTIONS = at least that many)
+} Suggestion;
+
+// SuggestionSearch - state shared by the threads evaluating suggestions
+typedef struct {
+    int tally[MAX_SIZE][MAX_SIZE][MAX_SIZE + 1]; // how many enumerated solutions put each number in each cell
+    Suggestion *candidates;                      // additions left to evaluate, most promising first
+    int numCandidates;                           // number of entries in candidates
+    int next;                                    // index of the next candidate to evaluate
+    Suggestion best[NUM_SUGGESTIONS];            // best additions found so far, fewest solutions first
+    int numBest;                                 // number of entries in best
+    struct timespec deadline;                    // time to stop starting new evaluations
+    Snapshot *board;                             // board the threads copy (taken once, so they never read the live grid)
+    pthread_mutex_t lock;                        // guards next, best, and numBest
+} SuggestionSearch;
+
+// SudokuSuggester - contains the following functions to suggest the givens that cut the number of solutions the most
+int suggestGivens(Suggestion *suggestions);                     // finds the givens that leave the fewest solutions (returns how many were found)
+void tallySolution(int (*solution)[MAX_SIZE], void *data);      // adds a solution to the tally of each cell's numbers
+void *evaluateSuggestions(void *arg);                           // thread loop that counts the solutions left by each candidate addition
+void keepSuggestion(SuggestionSearch *search, Suggestion next); // adds a suggestion to the best ones if it leaves fewer solutions
+int compareSuggestions(const void *a, const void *b);           // orders candidate additions by their tally (untallied ones last)
+
+// finds the givens that leave the fewest solutions (returns how many were found)
+int suggestGivens(Suggestion *suggestions) {
+    SuggestionSearch *search = calloc(1, sizeof(SuggestionSearch));
+    pthread_mutex_init(&search->lock, NULL);
+
+    //enumerate the solutions once, tallying where each one puts each number
+    int total = 0;
+    kernel->forEachSolution(0, 0, grid, &total, MAX_SOLUTIONS, tallySolution, search);
+
+    //nothing to suggest for a board that is impossible or already unique
+    int numFound = 0;
+    if (total > 1) {
+        bool complete = total < MAX_SOLUTIONS;
+
+        search->candidates = malloc(sizeof(Suggestion) * boardSize * boardSize * boardSize);
+        for (int row = 0; row < boardSize; row++) {
+            for (int col = 0; col < boardSize; col++) {
+                for (int num = 1; num <= boardSize && grid[row][col] == EMPTY; num++) {
+                    Suggestion next = {row, col, num, search->tally[row][col][num]};
+
+                    if (complete) {
+                        //every solution was enumerated, so the tally is the exact count (skip additions that change nothing)
+                        if (next.count > 0 && next.count < total) {
+                            keepSuggestion(search, next);
+                        }
+                    } else if (kernel->isValidShallow(row, col, num, grid)) {
+                        //too many solutions to enumerate, the tally only ranks which additions to count first
+                        search->candidates[search->numCandidates++] = next;
+                    }
+                }
+            }
+        }
+
+        if (!complete) {
+            qsort(search->candidates, search->numCandidates, sizeof(Suggestion), compareSuggestions);
+
+            //count the candidates in parallel until they run out or the time is up
+            clock_gettime(CLOCK_MONOTONIC, &search->deadline);
+            search->deadline.tv_sec += SUGGEST_SECONDS;
+
+            search->board = takeSnapshot(grid, NULL, NULL, NULL);
+            int numThreads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+            pthread_t *threads = malloc(sizeof(pthread_t) * numThreads);
+            for (int i = 0; i < numThreads; i++) {
+                pthread_create(&threads[i], NULL, evaluateSuggestions, search);
+            }
+            for (int i = 0; i < numThreads; i++) {
+                pthread_join(threads[i], NULL);
+            }
+            free(threads);
+            releaseSnapshot(search->board);
+        }
+
+        numFound = search->numBest;
+        memcpy(suggestions, search->best, sizeof(Suggestion) * numFound);
+        free(search->candidates);
+    }
+
+    pthread_mutex_destroy(&search->lock);
+    free(search);
+    return numFound;
+}
+
+// adds a solution to the tally of each cell's numbers
+void tallySolution(int (*solution)[MAX_SIZE], void *data) {
+    SuggestionSearch *search = data;
+    for (int row = 0; row < boardSize; row++) {
+        for (int col = 0; col < boardSize; col++) {
+            search->tally[row][col][solution[row][col]] += 1;
+        }
+    }
+}
+
+// thread loop that counts the solutions left by each candidate addition
+void *evaluateSuggestions(void *arg) {
+    SuggestionSearch *search = arg;
+
+    //each thread counts on its own copy of the board
+    int work[MAX_SIZE][MAX_SIZE];
+    restoreSnapshot(search->board, work, NULL, NULL);
+
+    while (true) {
+        struct timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+
+        pthread_mutex_lock(&search->lock);
+        bool timeUp = now.tv_sec > search->deadline.tv_sec || (now.tv_sec == search->deadline.tv_sec && now.tv_nsec >= search->deadline.tv_nsec);
+        if (timeUp || search->next == search->numCandidates) {
+            pthread_mutex_unlock(&search->lock);
+            break;
+        }
+        Suggestion next = search->candidates[search->next++];
+
+        //no need to count past the worst suggestion kept so far
+        int max = search->numBest == NUM_SUGGESTIONS ? search->best[NUM_SUGGESTIONS - 1].count : MAX_SOLUTIONS;
+        pthread_mutex_unlock(&search->lock);
+
+        next.count = 0;
+        work[next.row][next.col] = next.num;
+        kernel->getNumSolutions(0, 0, work, &next.count, max);
+        work[next.row][next.col] = EMPTY;
+
+        //additions that leave no solution are never suggested
+        if (next.count > 0 && (next.count < max || max == MAX_SOLUTIONS)) {
+            keepSuggestion(search, next);
+        }
+    }
+    return NULL;
+}
+
+// adds a suggestion to the best ones if it leaves fewer solutions
+void keepSuggestion(SuggestionSearch *search, Suggestion next) {
+    pthread_mutex_lock(&search->lock);
+    if (search->numBest < NUM_SUGGESTIONS || next.count < search->best[search->numBest - 1].count) {
+        //insert in order, dropping the worst if full
+        int i = search->numBest < NUM_SUGGESTIONS ? search->numBest++ : NUM_SUGGESTIONS - 1;
+        while (i > 0 && search->best[i - 1].count > next.count) {
+            search->best[i] = search->best[i - 1];
+            i--;
+        }
+        search->best[i] = next;
+    }
+    pthread_mutex_unlock(&search->lock);
+}
+
+// orders candidate additions by their tally (untallied ones last)
+int compareSuggestions(const void *a, const void *b) {
+    int countA = ((const Suggestion *)a)->count;
+    int countB = ((const Suggestion *)b)->count;
+    if (countA == 0 || countB == 0) {
+        return (countA == 0) - (countB == 0);
+    }
+    return countA - countB;
+}
@@ -0,0 +1,799 @@
+#include "SudokuDefinitions.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// boardSize - int value holding the number of rows, columns, and digits in the board (9, 16, or 25)
+extern int boardSize;
+// boxSize - int value holding the number of rows and columns in each box (3, 4, or 5)
+extern int boxSize;
+
+// Variant - the rules of a variant board as tables of units (groups of cells that can't repeat a number) and peers
+typedef struct {
+    int region[MAX_SIZE][MAX_SIZE];                           // region of each cell (its box, or its piece on a jigsaw board)
+    bool jigsaw;                                              // true if the regions replace the boxes
+    bool diagonal;                                            // true if neither main diagonal can repeat a number
+    int numCages;                                             // number of killer cages
+    int cageOf[MAX_SIZE][MAX_SIZE];                           // cage of each cell (-1 = not in a cage)
+    int cageSum[VARIANT_MAX_CAGES];                           // sum of the numbers in each cage
+    int cageAnchor[VARIANT_MAX_CAGES];                        // first cell of each cage in reading order (where its sum is printed)
+    int firstCage;                                            // unit of the first cage (the cages are the last units)
+    int numUnits;                                             // number of units (rows, columns, regions, diagonals, then cages)
+    int unitCells[VARIANT_MAX_UNITS][MAX_SIZE];               // cells of each unit (as row * boardSize + col)
+    int unitSize[VARIANT_MAX_UNITS];                          // number of cells in each unit
+    int cellUnits[MAX_SIZE * MAX_SIZE][VARIANT_CELL_UNITS];   // units of each cell
+    int numCellUnits[MAX_SIZE * MAX_SIZE];                    // number of units of each cell
+    int peers[MAX_SIZE * MAX_SIZE][VARIANT_MAX_PEERS];        // other cells sharing a unit with each cell
+    int numPeers[MAX_SIZE * MAX_SIZE];                        // number of peers of each cell
+    uint32_t *combos;                                         // every set of distinct numbers, grouped by how many and their sum (only for cages)
+    int comboStart[VARIANT_CAGE_SIZE + 1][VARIANT_MAX_SUM + 2]; // index in combos of the first set of each size and sum
+} Variant;
+
+// search state for one run of the variant solver (kept on the stack so separate boards can be searched at the same time)
+typedef struct {
+    uint32_t used[VARIANT_MAX_UNITS];      // numbers currently used in each unit
+    int cageLeft[VARIANT_MAX_CAGES];       // sum the empty cells of each cage still need
+    int cageEmpty[VARIANT_MAX_CAGES];      // number of empty cells in each cage
+    bool broken;                           // true if a full cage has the wrong sum (no solutions)
+    int (*grid)[MAX_SIZE];                 // board being searched
+    bool (*given)[MAX_SIZE];               // given cells of the board being searched
+    bool (*correct)[MAX_SIZE];             // correct cells of the board being searched (only used by markSolution)
+    int *solved;                           // solved state of the board being searched (only used by markSolution)
+    int *count;                            // number of solutions found so far (only used by getNumSolutions)
+    int max;                               // number of solutions to stop at (only used by getNumSolutions)
+    void (*visit)(int (*grid)[MAX_SIZE], void *data); // called with each solution counted (NULL = only count)
+    void *data;                                       // passed along to visit
+    int empty[MAX_SIZE * MAX_SIZE];        // indexes of the cells left to fill (not used by markSolution)
+    int numEmpty;                          // number of entries in empty
+    long long nodes;                       // cells tried by this search (added to kernelNodes when it ends)
+    long long limit;                       // number of cells to give up after (copied from kernelNodeLimit)
+} VariantSearch;
+
+// variant - the rules loaded with --variant (NULL = standard sudoku, solved by the specialized kernels)
+Variant *variant = NULL;
+// variantKernel - the table-driven solver for the loaded variant, in the same shape as the specialized kernels
+SudokuKernel variantKernel;
+
+// SudokuVariant - contains the following functions to solve diagonal, jigsaw, and killer boards from precomputed unit and peer tables
+bool loadVariant(char *path);                                                                 // reads the rules of a variant board and switches the solver to them
+bool parseVariantLine(char *line, FILE *file, int *numRegions, char *names);                  // handles one line of a variant file (returns false if it is invalid)
+bool buildVariantTables();                                                                    // lists the units, peers, and cage sets of the loaded rules
+void addVariantUnit(int *cells, int size);                                                    // adds a unit and records it on each of its cells
+bool hasVariantSolution();                                                                    // checks that the loaded rules allow at least one solution
+int regionOf(int row, int col);                                                               // returns the region of the cell for the grid outlines
+int cageLabel(int row, int col);                                                              // returns the sum of the cage the cell is the first cell of (0 if none)
+bool inSameCage(int row1, int col1, int row2, int col2);                                      // checks if both cells are on the board and in the same killer cage
+uint64_t hashVariant();                                                                        // hashes the rules (so boards under other rules never share a cached count)
+uint32_t cageNums(int cells, int sum, uint32_t used);                                         // returns the numbers that fit in a cage with this many empty cells left
+bool variantGenSolution(int row, int col, int (*grid)[MAX_SIZE], bool (*given)[MAX_SIZE]);    // resolves the board with recursive backtracking
+bool variantMarkSolution(int row, int col, int (*grid)[MAX_SIZE], bool (*given)[MAX_SIZE], bool (*correct)[MAX_SIZE], int *solved); // marks incorrect cells with recursive backtracking
+void variantGetNumSolutions(int row, int col, int (*grid)[MAX_SIZE], int *count, int max);    // calculates the number of solutions of the board (up to the max)
+void variantForEachSolution(int row, int col, int (*grid)[MAX_SIZE], int *count, int max, void (*visit)(int (*grid)[MAX_SIZE], void *data), void *data); // calls visit with each solution of the board (up to the max)
+bool variantGetCandidates(int (*grid)[MAX_SIZE], uint32_t (*candidates)[MAX_SIZE]);           // finds the numbers each empty cell takes in at least one solution
+bool variantIsValidShallow(int row, int col, int num, int (*grid)[MAX_SIZE]);                 // checks the cell against its peers and its cage's sum
+
+// reads the rules of a variant board and switches the solver to them
+// one rule per line: 'size 16', 'diagonal', 'regions' followed by a line per row naming each cell's piece, or 'cage 10 A1 A2 B1'
+bool loadVariant(char *path) {
+    FILE *file = fopen(path, "r");
+    if (file == NULL) {
+        perror(path);
+        return false;
+    }
+
+    variant = calloc(1, sizeof(Variant));
+    memset(variant->cageOf, -1, sizeof(variant->cageOf));
+    int numRegions = 0;
+    char names[MAX_SIZE];
+    char line[512];
+    int lineNum = 0;
+    bool valid = true;
+
+    while (valid && fgets(line, sizeof(line), file) != NULL) {
+        lineNum++;
+        line[strcspn(line, "\r\n")] = '\0';
+        valid = parseVariantLine(line, file, &numRegions, names);
+    }
+    fclose(file);
+
+    if (!valid) {
+        fprintf(stderr, "%s:%d: invalid variant rule '%s'\n", path, lineNum, line);
+    } else if (!buildVariantTables()) {
+        fprintf(stderr, "%s: the regions and cages don't fit a %dx%d board\n", path, boardSize, boardSize);
+        valid = false;
+    } else if (!hasVariantSolution()) {
+        //rules that contradict each other leave no board to solve or generate
+        fprintf(stderr, "%s: the rules don't allow any solution\n", path);
+        valid = false;
+    }
+    if (!valid) {
+        free(variant->combos);
+        free(variant);
+        variant = NULL;
+        return false;
+    }
+
+    //the variant solver takes the place of the specialized kernel (no known lower bound on the givens)
+    variantKernel = (SudokuKernel){boxSize, boardSize, 0, variantGenSolution, variantMarkSolution, variantGetNumSolutions,
+                                   variantIsValidShallow, variantGetCandidates, variantForEachSolution};
+    kernel = &variantKernel;
+    return true;
+}
+
+// handles one line of a variant file (returns false if it is invalid)
+bool parseVariantLine(char *line, FILE *file, int *numRegions, char *names) {
+    char word[16];
+    int offset;
+    if (sscanf(line, "%15s%n", word, &offset) != 1 || word[0] == '#') {
+        //blank lines and comments
+        return true;
+    }
+
+    if (strcmp(word, "size") == 0) {
+        //has to come before the regions and cages, which are checked against the size
+        return variant->numCages == 0 && *numRegions == 0 && selectKernel(atoi(line + offset));
+    } else if (strcmp(word, "diagonal") == 0) {
+        variant->diagonal = true;
+        return true;
+    } else if (strcmp(word, "regions") == 0) {
+        //one line per row, each character names the region of its cell
+        char row[MAX_SIZE + 8];
+        for (int r = 0; r < boardSize; r++) {
+            if (fgets(row, sizeof(row), file) == NULL) {
+                return false;
+            }
+            row[strcspn(row, "\r\n")] = '\0';
+            if ((int)strlen(row) != boardSize) {
+                return false;
+            }
+            for (int c = 0; c < boardSize; c++) {
+                char *known = memchr(names, row[c], *numRegions);
+                if (known == NULL) {
+                    if (*numRegions == boardSize) {
+                        return false;
+                    }
+                    names[*numRegions] = row[c];
+                    known = &names[(*numRegions)++];
+                }
+                variant->region[r][c] = known - names;
+            }
+        }
+        variant->jigsaw = true;
+        return true;
+    } else if (strcmp(word, "cage") == 0) {
+        //the sum, then the cells (ie 'cage 10 A1 A2 B1')
+        if (boardSize > VARIANT_CAGE_SIZE || variant->numCages == VARIANT_MAX_CAGES) {
+            return false;
+        }
+        char *rest = line + offset;
+        int sum, cage = variant->numCages, numCells = 0;
+        if (sscanf(rest, "%d%n", &sum, &offset) != 1) {
+            return false;
+        }
+        rest += offset;
+
+        char cell[8];
+        while (sscanf(rest, "%7s%n", cell, &offset) == 1) {
+            rest += offset;
+            int row = cell[0] - 'A';
+            int col = atoi(cell + 1) - 1;
+            if (row < 0 || row >= boardSize || col < 0 || col >= boardSize || variant->cageOf[row][col] >= 0 || numCells == boardSize) {
+                return false;
+            }
+            variant->cageOf[row][col] = cage;
+            numCells++;
+        }
+        if (numCells == 0 || sum < numCells * (numCells + 1) / 2 || sum > numCells * (2 * boardSize - numCells + 1) / 2) {
+            return false;
+        }
+        variant->cageSum[cage] = sum;
+        variant->numCages++;
+        return true;
+    }
+    return false;
+}
+
+// lists the units, peers, and cage sets of the loaded rules
+bool buildVariantTables() {
+    int cells[MAX_SIZE];
+
+    //a jigsaw piece has to hold exactly one of each number
+    int regionSizes[MAX_SIZE] = {0};
+    for (int row = 0; row < boardSize; row++) {
+        for (int col = 0; col < boardSize; col++) {
+            if (!variant->jigsaw) {
+                variant->region[row][col] = row / boxSize * boxSize + col / boxSize;
+            }
+            regionSizes[variant->region[row][col]]++;
+        }
+    }
+    for (int i = 0; i < boardSize; i++) {
+        if (regionSizes[i] != boardSize) {
+            return false;
+        }
+    }
+
+    //rows, columns, and regions
+    for (int i = 0; i < boardSize; i++) {
+        for (int j = 0; j < boardSize; j++) {
+            cells[j] = i * boardSize + j;
+        }
+        addVariantUnit(cells, boardSize);
+    }
+    for (int i = 0; i < boardSize; i++) {
+        for (int j = 0; j < boardSize; j++) {
+            cells[j] = j * boardSize + i;
+        }
+        addVariantUnit(cells, boardSize);
+    }
+    for (int i = 0; i < boardSize; i++) {
+        int size = 0;
+        for (int cell = 0; cell < boardSize * boardSize; cell++) {
+            if (variant->region[cell / boardSize][cell % boardSize] == i) {
+                cells[size++] = cell;
+            }
+        }
+        addVariantUnit(cells, size);
+    }
+
+    //both main diagonals
+    if (variant->diagonal) {
+        for (int i = 0; i < boardSize; i++) {
+            cells[i] = i * boardSize + i;
+        }
+        addVariantUnit(cells, boardSize);
+        for (int i = 0; i < boardSize; i++) {
+            cells[i] = i * boardSize + boardSize - 1 - i;
+        }
+        addVariantUnit(cells, boardSize);
+    }
+
+    //a cage can't repeat a number either, so each one is a unit with a sum
+    variant->firstCage = variant->numUnits;
+    for (int cage = 0; cage < variant->numCages; cage++) {
+        int size = 0;
+        for (int cell = 0; cell < boardSize * boardSize; cell++) {
+            if (variant->cageOf[cell / boardSize][cell % boardSize] == cage) {
+                cells[size++] = cell;
+            }
+        }
+        variant->cageAnchor[cage] = cells[0];
+        addVariantUnit(cells, size);
+    }
+
+    //the peers of a cell are every other cell in its units, listed once
+    for (int cell = 0; cell < boardSize * boardSize; cell++) {
+        bool seen[MAX_SIZE * MAX_SIZE] = {false};
+        seen[cell] = true;
+        for (int i = 0; i < variant->numCellUnits[cell]; i++) {
+            int unit = variant->cellUnits[cell][i];
+            for (int j = 0; j < variant->unitSize[unit]; j++) {
+                int peer = variant->unitCells[unit][j];
+                if (!seen[peer]) {
+                    seen[peer] = true;
+                    variant->peers[cell][variant->numPeers[cell]++] = peer;
+                }
+            }
+        }
+    }
+
+    //group every set of distinct numbers by its size and sum, so a cage's possible numbers are a few lookups
+    if (variant->numCages > 0) {
+        int numSets = 1 << boardSize;
+        int counts[VARIANT_CAGE_SIZE + 1][VARIANT_MAX_SUM + 1] = {{0}};
+        int *sums = malloc(sizeof(int) * numSets);
+        for (int set = 1; set < numSets; set++) {
+            sums[set] = 0;
+            for (int num = 1; num <= boardSize; num++) {
+                sums[set] += (set >> (num - 1) & 1) * num;
+            }
+            counts[__builtin_popcount(set)][sums[set]]++;
+        }
+
+        int next = 0;
+        for (int size = 0; size <= VARIANT_CAGE_SIZE; size++) {
+            for (int sum = 0; sum <= VARIANT_MAX_SUM; sum++) {
+                variant->comboStart[size][sum] = next;
+                next += counts[size][sum];
+            }
+            variant->comboStart[size][VARIANT_MAX_SUM + 1] = next;
+        }
+
+        variant->combos = malloc(sizeof(uint32_t) * numSets);
+        int fill[VARIANT_CAGE_SIZE + 1][VARIANT_MAX_SUM + 1];
+        memset(fill, 0, sizeof(fill));
+        for (int set = 1; set < numSets; set++) {
+            int size = __builtin_popcount(set);
+            variant->combos[variant->comboStart[size][sums[set]] + fill[size][sums[set]]++] = set;
+        }
+        free(sums);
+    }
+    return true;
+}
+
+// adds a unit and records it on each of its cells
+void addVariantUnit(int *cells, int size) {
+    int unit = variant->numUnits++;
+    variant->unitSize[unit] = size;
+    for (int i = 0; i < size; i++) {
+        variant->unitCells[unit][i] = cells[i];
+        variant->cellUnits[cells[i]][variant->numCellUnits[cells[i]]++] = unit;
+    }
+}
+
+// checks that the loaded rules allow at least one solution
+bool hasVariantSolution() {
+    int empty[MAX_SIZE][MAX_SIZE] = {{0}};
+    int count = 0;
+    variantGetNumSolutions(0, 0, empty, &count, 1);
+    return count > 0;
+}
+
+// returns the region of the cell for the grid outlines
+int regionOf(int row, int col) {
+    if (variant == NULL) {
+        return row / boxSize * boxSize + col / boxSize;
+    }
+    return variant->region[row][col];
+}
+
+// returns the sum of the cage the cell is the first cell of (0 if none)
+int cageLabel(int row, int col) {
+    if (variant == NULL || variant->cageOf[row][col] < 0) {
+        return 0;
+    }
+    int cage = variant->cageOf[row][col];
+    return variant->cageAnchor[cage] == row * boardSize + col ? variant->cageSum[cage] : 0;
+}
+
+// checks if both cells are on the board and in the same killer cage
+bool inSameCage(int row1, int col1, int row2, int col2) {
+    if (variant == NULL || row1 < 0 || row1 >= boardSize || col1 < 0 || col1 >= boardSize || row2 < 0 || row2 >= boardSize || col2 < 0 || col2 >= boardSize) {
+        return false;
+    }
+    return variant->cageOf[row1][col1] >= 0 && variant->cageOf[row1][col1] == variant->cageOf[row2][col2];
+}
+
+// hashes the rules (so boards under other rules never share a cached count)
+uint64_t hashVariant() {
+    //FNV-1a over each cell's region and cage, then the cage sums
+    uint64_t hash = 0xcbf29ce484222325ULL ^ variant->diagonal;
+    for (int row = 0; row < boardSize; row++) {
+        for (int col = 0; col < boardSize; col++) {
+            hash = (hash ^ (uint64_t)(variant->region[row][col] * (VARIANT_MAX_CAGES + 1) + variant->cageOf[row][col] + 1)) * 0x100000001b3ULL;
+        }
+    }
+    for (int cage = 0; cage < variant->numCages; cage++) {
+        hash = (hash ^ (uint64_t)variant->cageSum[cage]) * 0x100000001b3ULL;
+    }
+
+    //0 is left for the standard rules
+    return hash | 1;
+}
+
+// returns the numbers that fit in a cage with this many empty cells left
+// sum is what the empty cells still need and used holds the numbers already in the cage
+uint32_t cageNums(int cells, int sum, uint32_t used) {
+    if (cells <= 0 || sum <= 0 || sum > VARIANT_MAX_SUM) {
+        return 0;
+    }
+
+    //any number of a set that avoids the numbers already used
+    uint32_t nums = 0;
+    for (int i = variant->comboStart[cells][sum]; i < variant->comboStart[cells][sum + 1]; i++) {
+        if ((variant->combos[i] & used) == 0) {
+            nums |= variant->combos[i];
+        }
+    }
+    return nums;
+}
+
+// returns the numbers that don't repeat one in the cell's units and still let its cage reach its sum
+static inline uint32_t variantFreeNums(VariantSearch *s, int cell) {
+    uint32_t taken = 0;
+    for (int i = 0; i < variant->numCellUnits[cell]; i++) {
+        taken |= s->used[variant->cellUnits[cell][i]];
+    }
+    uint32_t free = ~taken & (uint32_t)((1ULL << boardSize) - 1);
+
+    int cage = variant->cageOf[cell / boardSize][cell % boardSize];
+    if (cage >= 0) {
+        free &= cageNums(s->cageEmpty[cage], s->cageLeft[cage], s->used[variant->firstCage + cage]);
+    }
+    return free;
+}
+
+// marks a number as used in the cell's units and cage
+static inline void variantPlace(VariantSearch *s, int cell, uint32_t bit, int num) {
+    for (int i = 0; i < variant->numCellUnits[cell]; i++) {
+        s->used[variant->cellUnits[cell][i]] |= bit;
+    }
+    int cage = variant->cageOf[cell / boardSize][cell % boardSize];
+    if (cage >= 0) {
+        s->cageLeft[cage] -= num;
+        s->cageEmpty[cage]--;
+    }
+}
+
+// marks a number as no longer used in the cell's units and cage
+static inline void variantLift(VariantSearch *s, int cell, uint32_t bit, int num) {
+    for (int i = 0; i < variant->numCellUnits[cell]; i++) {
+        s->used[variant->cellUnits[cell][i]] &= ~bit;
+    }
+    int cage = variant->cageOf[cell / boardSize][cell % boardSize];
+    if (cage >= 0) {
+        s->cageLeft[cage] += num;
+        s->cageEmpty[cage]++;
+    }
+}
+
+// fills the unit masks and cage sums from the numbers currently in the grid
+static void variantLoad(VariantSearch *s) {
+    memset(s->used, 0, sizeof(uint32_t) * variant->numUnits);
+    for (int cage = 0; cage < variant->numCages; cage++) {
+        s->cageLeft[cage] = variant->cageSum[cage];
+        s->cageEmpty[cage] = variant->unitSize[variant->firstCage + cage];
+    }
+    for (int cell = 0; cell < boardSize * boardSize; cell++) {
+        int num = s->grid[cell / boardSize][cell % boardSize];
+        if (num != EMPTY) {
+            variantPlace(s, cell, 1u << (num - 1), num);
+        }
+    }
+
+    //a full cage with the wrong sum can't be fixed by filling other cells
+    s->broken = false;
+    for (int cage = 0; cage < variant->numCages; cage++) {
+        s->broken |= s->cageEmpty[cage] == 0 && s->cageLeft[cage] != 0;
+    }
+}
+
+// marks incorrect cells from the given cell onwards, visiting cells in the same order as the original backtracker
+static bool variantMarkSolutionFrom(VariantSearch *s, int cell) {
+    s->nodes++;
+
+    //give up once the search has tried too many cells
+    if (s->nodes > s->limit) {
+        return false;
+    }
+
+    //skip given cells
+    while (cell < boardSize * boardSize && s->given[cell / boardSize][cell % boardSize]) {
+        cell++;
+    }
+
+    //base case: reached the end of the board -> solved
+    if (cell == boardSize * boardSize) {
+        return true;
+    }
+
+    int row = cell / boardSize;
+    int col = cell % boardSize;
+
+    //save initial number
+    int prev = s->grid[row][col];
+
+    //try each valid number from lowest to highest
+    for (int num = 1; num <= boardSize; num++) {
+        if (variantIsValidShallow(row, col, num, s->grid)) {
+            //assume temporarily this number is right
+            s->grid[row][col] = num;
+
+            //recursively check the next cell
+            if (variantMarkSolutionFrom(s, cell + 1)) {
+                //if found a solution, compare to the initial value
+                if (prev != num) {
+                    //if not correct, update correct array and revert cell
+                    s->correct[row][col] = false;
+                    *s->solved = WRONG;
+                }
+                s->grid[row][col] = prev;
+                return true;
+            }
+        }
+    }
+
+    //if didn't find a solution, reset the cell
+    s->grid[row][col] = prev;
+
+    //return to parent for backtracking
+    return false;
+}
+
+// moves the remaining empty cell with the fewest free numbers to the front of the remaining cells and returns its free numbers
+static uint32_t variantPickCell(VariantSearch *s, int depth) {
+    int best = depth;
+    uint32_t bestFree = 0;
+    int bestCount = boardSize + 1;
+    for (int i = depth; i < s->numEmpty; i++) {
+        uint32_t free = variantFreeNums(s, s->empty[i]);
+        int count = __builtin_popcount(free);
+        if (count < bestCount) {
+            best = i;
+            bestFree = free;
+            bestCount = count;
+
+            //can't do better than a forced or impossible cell
+            if (count <= 1) {
+                break;
+            }
+        }
+    }
+
+    int cell = s->empty[best];
+    s->empty[best] = s->empty[depth];
+    s->empty[depth] = cell;
+    return bestFree;
+}
+
+// counts the solutions for the remaining empty cells, always branching on the cell with the fewest free numbers
+static void variantCountFrom(VariantSearch *s, int depth) {
+    s->nodes++;
+
+    //give up once the search has tried too many cells
+    if (s->nodes > s->limit) {
+        return;
+    }
+
+    //base case: every empty cell is filled -> solved
+    if (depth == s->numEmpty) {
+        *s->count += 1;
+        if (s->visit != NULL) {
+            s->visit(s->grid, s->data);
+        }
+        return;
+    }
+
+    uint32_t free = variantPickCell(s, depth);
+    int cell = s->empty[depth];
+    while (free) {
+        uint32_t bit = free & -free;
+        free ^= bit;
+        int num = __builtin_ctz(bit) + 1;
+
+        //assume temporarily this number is right
+        s->grid[cell / boardSize][cell % boardSize] = num;
+        variantPlace(s, cell, bit, num);
+
+        //recursively fill the remaining cells
+        variantCountFrom(s, depth + 1);
+
+        //reset the cell
+        variantLift(s, cell, bit, num);
+        s->grid[cell / boardSize][cell % boardSize] = EMPTY;
+
+        //if reached the maximum solution count, stop the recursion
+        if (*s->count >= s->max) {
+            return;
+        }
+    }
+}
+
+// fills the remaining empty cells with the first solution found, leaving them empty if there is none
+static bool variantFindFrom(VariantSearch *s, int depth) {
+    s->nodes++;
+
+    //give up once the search has tried too many cells
+    if (s->nodes > s->limit) {
+        return false;
+    }
+
+    //base case: every empty cell is filled -> solved
+    if (depth == s->numEmpty) {
+        return true;
+    }
+
+    uint32_t free = variantPickCell(s, depth);
+    int cell = s->empty[depth];
+    while (free) {
+        uint32_t bit = free & -free;
+        free ^= bit;
+        int num = __builtin_ctz(bit) + 1;
+
+        //assume temporarily this number is right
+        s->grid[cell / boardSize][cell % boardSize] = num;
+        variantPlace(s, cell, bit, num);
+
+        //recursively fill the remaining cells, keeping the first solution
+        if (variantFindFrom(s, depth + 1)) {
+            return true;
+        }
+
+        //reset the cell
+        variantLift(s, cell, bit, num);
+        s->grid[cell / boardSize][cell % boardSize] = EMPTY;
+    }
+    return false;
+}
+
+// adds the numbers of a solution to the candidates of each empty cell, then empties the cells again
+static void variantTakeWitness(VariantSearch *s, uint32_t (*candidates)[MAX_SIZE]) {
+    for (int i = 0; i < s->numEmpty; i++) {
+        int row = s->empty[i] / boardSize;
+        int col = s->empty[i] % boardSize;
+        int num = s->grid[row][col];
+        candidates[row][col] |= 1u << (num - 1);
+        variantLift(s, s->empty[i], 1u << (num - 1), num);
+        s->grid[row][col] = EMPTY;
+    }
+}
+
+// resolves the board with recursive backtracking, always branching on the cell with the fewest free numbers
+bool variantGenSolution(int row, int col, int (*grid)[MAX_SIZE], bool (*given)[MAX_SIZE]) {
+    VariantSearch s;
+    s.grid = grid;
+    s.given = given;
+    s.nodes = 0;
+    s.limit = kernelNodeLimit;
+
+    //every cell that isn't given from the starting cell onwards is filled in again (left empty if there is no solution)
+    s.numEmpty = 0;
+    for (int cell = row * boardSize + col; cell < boardSize * boardSize; cell++) {
+        if (!given[cell / boardSize][cell % boardSize]) {
+            grid[cell / boardSize][cell % boardSize] = EMPTY;
+            s.empty[s.numEmpty++] = cell;
+        }
+    }
+    variantLoad(&s);
+
+    bool found = !s.broken && variantFindFrom(&s, 0);
+    kernelNodes += s.nodes;
+    return found;
+}
+
+// marks incorrect cells with recursive backtracking
+bool variantMarkSolution(int row, int col, int (*grid)[MAX_SIZE], bool (*given)[MAX_SIZE], bool (*correct)[MAX_SIZE], int *solved) {
+    VariantSearch s;
+    s.grid = grid;
+    s.given = given;
+    s.correct = correct;
+    s.solved = solved;
+    s.nodes = 0;
+    s.limit = kernelNodeLimit;
+
+    bool found = variantMarkSolutionFrom(&s, row * boardSize + col);
+    kernelNodes += s.nodes;
+    return found;
+}
+
+// calls visit with each solution of the board (up to the max), counting them like getNumSolutions
+void variantForEachSolution(int row, int col, int (*grid)[MAX_SIZE], int *count, int max, void (*visit)(int (*grid)[MAX_SIZE], void *data), void *data) {
+    VariantSearch s;
+    s.grid = grid;
+    s.count = count;
+    s.max = max;
+    s.visit = visit;
+    s.data = data;
+    s.nodes = 0;
+    s.limit = kernelNodeLimit;
+    variantLoad(&s);
+    if (s.broken) {
+        return;
+    }
+
+    //only the empty cells from the starting cell onwards are filled in
+    s.numEmpty = 0;
+    for (int cell = row * boardSize + col; cell < boardSize * boardSize; cell++) {
+        if (grid[cell / boardSize][cell % boardSize] == EMPTY) {
+            s.empty[s.numEmpty++] = cell;
+        }
+    }
+
+    variantCountFrom(&s, 0);
+    kernelNodes += s.nodes;
+}
+
+// calculates the number of solutions of the board (up to the max)
+void variantGetNumSolutions(int row, int col, int (*grid)[MAX_SIZE], int *count, int max) {
+    variantForEachSolution(row, col, grid, count, max, NULL, NULL);
+}
+
+// finds the numbers each empty cell takes in at least one solution (returns false if there are no solutions)
+bool variantGetCandidates(int (*grid)[MAX_SIZE], uint32_t (*candidates)[MAX_SIZE]) {
+    //search a copy so the board is left untouched
+    int work[MAX_SIZE][MAX_SIZE];
+    VariantSearch s;
+    s.grid = work;
+    s.numEmpty = 0;
+    s.nodes = 0;
+    s.limit = kernelNodeLimit;
+    for (int row = 0; row < boardSize; row++) {
+        for (int col = 0; col < boardSize; col++) {
+            work[row][col] = grid[row][col];
+            candidates[row][col] = 0;
+            if (grid[row][col] == EMPTY) {
+                s.empty[s.numEmpty++] = row * boardSize + col;
+            }
+        }
+    }
+    variantLoad(&s);
+
+    //every number of the first solution is a candidate
+    if (s.broken || !variantFindFrom(&s, 0)) {
+        kernelNodes += s.nodes;
+        return false;
+    }
+    variantTakeWitness(&s, candidates);
+
+    //the searches below reorder the empty list, so walk the cells from a copy
+    int cells[MAX_SIZE * MAX_SIZE];
+    memcpy(cells, s.empty, sizeof(int) * s.numEmpty);
+
+    //only search for the free numbers no solution has used yet, every solution found fills in other cells too
+    for (int i = 0; i < s.numEmpty; i++) {
+        //keep the cell at the front so the search only fills the other cells
+        int cell = cells[i];
+        for (int j = 0; j < s.numEmpty; j++) {
+            if (s.empty[j] == cell) {
+                s.empty[j] = s.empty[0];
+                s.empty[0] = cell;
+                break;
+            }
+        }
+
+        int row = cell / boardSize;
+        int col = cell % boardSize;
+        uint32_t untried = variantFreeNums(&s, cell) & ~candidates[row][col];
+        while (untried) {
+            uint32_t bit = untried & -untried;
+            untried ^= bit;
+            int num = __builtin_ctz(bit) + 1;
+
+            s.grid[row][col] = num;
+            variantPlace(&s, cell, bit, num);
+            if (variantFindFrom(&s, 1)) {
+                variantTakeWitness(&s, candidates);
+
+                //the witness may have covered other untried numbers of this cell
+                untried &= ~candidates[row][col];
+            } else {
+                variantLift(&s, cell, bit, num);
+                s.grid[row][col] = EMPTY;
+            }
+        }
+    }
+    kernelNodes += s.nodes;
+    return true;
+}
+
+// checks the cell against its peers and its cage's sum
+bool variantIsValidShallow(int row, int col, int num, int (*grid)[MAX_SIZE]) {
+    int cell = row * boardSize + col;
+
+    //check for duplicates in every unit of the cell
+    for (int i = 0; i < variant->numPeers[cell]; i++) {
+        int peer = variant->peers[cell][i];
+        if (grid[peer / boardSize][peer % boardSize] == num) {
+            return false;
+        }
+    }
+
+    //the cage's other numbers plus this one must leave a sum its empty cells can still make
+    int cage = variant->cageOf[row][col];
+    if (cage >= 0) {
+        int unit = variant->firstCage + cage;
+        int left = variant->cageSum[cage] - num;
+        int empty = 0;
+        uint32_t used = 1u << (num - 1);
+        for (int i = 0; i < variant->unitSize[unit]; i++) {
+            int other = variant->unitCells[unit][i];
+            int otherNum = grid[other / boardSize][other % boardSize];
+            if (other == cell) {
+                continue;
+            } else if (otherNum == EMPTY) {
+                empty++;
+            } else {
+                left -= otherNum;
+                used |= 1u << (otherNum - 1);
+            }
+        }
+        if (empty == 0 ? left != 0 : cageNums(empty, left, used) == 0) {
+            return false;
+        }
+    }
+
+    //cell passed shallow tests
+    return true;
+}